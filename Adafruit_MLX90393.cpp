@@ -37,6 +37,70 @@ bool Adafruit_MLX90393::begin_I2C(uint8_t i2c_addr, TwoWire *wire) {
   return _init();
 }
 
+/**
+ * Shares the bus with other instances, possibly on other tasks.
+ *
+ * @param lock  Lock taken around every command, or NULL for none.
+ */
+void Adafruit_MLX90393::setBusLock(Adafruit_MLX90393_BusLock *lock) {
+  _bus_lock = lock;
+}
+
+/**
+ *    @brief  Sets the I2C address and bus without talking to the sensor
+ *    @param  i2c_addr
+ *            The I2C address to be used.
+ *    @param  wire
+ *            The Wire object to be used for I2C connections.
+ */
+void Adafruit_MLX90393::attach(uint8_t i2c_addr, TwoWire *wire) {
+  _i2c_address = i2c_addr;
+  _i2c = wire;
+  wire->begin();
+}
+
+/**
+ *    @brief  Copies the cached configuration into a compact state
+ *    @param  state
+ *            Where the state is stored.
+ */
+void Adafruit_MLX90393::saveState(mlx90393_state_t *state) const {
+  state->tref = _tref;
+  state->addr = _i2c_address;
+  state->tcmp_en = _tcmp_en;
+  state->gain = _gain;
+  state->filter = _dig_filt;
+  state->osr = _osr;
+  state->res_x = _res_x;
+  state->res_y = _res_y;
+  state->res_z = _res_z;
+  state->osr2 = _osr2;
+}
+
+/**
+ *    @brief  Points the instance at the sensor described by a compact state
+ *    @param  state
+ *            A state filled in by saveState.
+ *    @param  wire
+ *            The Wire object the sensor is on.
+ */
+void Adafruit_MLX90393::loadState(const mlx90393_state_t &state,
+                                  TwoWire *wire) {
+  _i2c = wire;
+  _i2c_address = state.addr;
+  _tref = state.tref;
+  _tcmp_en = state.tcmp_en;
+  _gain = (mlx90393_gain_t)state.gain;
+  _dig_filt = (mlx90393_filter_t)state.filter;
+  _osr = (mlx90393_oversampling_t)state.osr;
+  _res_x = (mlx90393_resolution_t)state.res_x;
+  _res_y = (mlx90393_resolution_t)state.res_y;
+  _res_z = (mlx90393_resolution_t)state.res_z;
+  _osr2 = (mlx90393_oversampling_t)state.osr2;
+  _meas_state = MLX90393_MEAS_IDLE;
+  _trig_axes = 0;
+}
+
 bool Adafruit_MLX90393::_init(void) {
   if (!exitMode())
     return false;
@@ -44,33 +108,53 @@ bool Adafruit_MLX90393::_init(void) {
   if (!reset())
     return false;
 
-  /* Set gain and sensor config. */
-  if (!setGain(MLX90393_GAIN_1X)) {
+  /* Gain, resolution, oversampling, filtering, INT pin as output. */
+  return applyConfig(mlx90393_config_t());
+}
+
+/**
+ * Applies a complete configuration.
+ *
+ * @param config  The settings to write.
+ *
+ * @return True if the operation succeeded, otherwise false.
+ */
+bool Adafruit_MLX90393::applyConfig(const mlx90393_config_t &config) {
+  uint16_t conf1 = 0, conf2 = 0, conf3 = 0;
+  if (!readRegister(MLX90393_CONF1, &conf1) ||
+      !readRegister(MLX90393_CONF2, &conf2) ||
+      !readRegister(MLX90393_CONF3, &conf3)) {
     return false;
   }
 
-  /* Set resolution. */
-  if (!setResolution(MLX90393_X, MLX90393_RES_16))
-    return false;
-  if (!setResolution(MLX90393_Y, MLX90393_RES_16))
-    return false;
-  if (!setResolution(MLX90393_Z, MLX90393_RES_16))
-    return false;
+  conf1 &= ~0x0070;
+  conf1 |= config.gain << MLX90393_GAIN_SHIFT;
 
-  /* Set oversampling. */
-  if (!setOversampling(MLX90393_OSR_3))
-    return false;
+  conf2 &= ~(0x8000 | MLX90393_TCMP_EN);
+  conf2 |= (config.trig_int ? 0x8000 : 0) |
+           (config.tcmp_en ? MLX90393_TCMP_EN : 0);
 
-  /* Set digital filtering. */
-  if (!setFilter(MLX90393_FILTER_7))
-    return false;
+  conf3 &= ~0x1FFF;
+  conf3 |= config.osr2 << 11 | config.res_z << 9 | config.res_y << 7 |
+           config.res_x << 5 | config.filter << 2 | config.osr;
 
-  /* set INT pin to output interrupt */
-  if (!setTrigInt(false)) {
+  if (!writeRegister(MLX90393_CONF1, conf1) ||
+      !writeRegister(MLX90393_CONF2, conf2) ||
+      !writeRegister(MLX90393_CONF3, conf3)) {
     return false;
   }
 
-  return true;
+  _gain = config.gain;
+  _res_x = config.res_x;
+  _res_y = config.res_y;
+  _res_z = config.res_z;
+  _dig_filt = config.filter;
+  _osr = config.osr;
+  _osr2 = config.osr2;
+  _tcmp_en = config.tcmp_en;
+
+  /* Per-part temperature reference, used to convert T to degrees C. */
+  return readRegister(MLX90393_TREF, &_tref);
 }
 
 /**
@@ -86,6 +170,30 @@ bool Adafruit_MLX90393::exitMode(void) {
                     MLX90393_STATUS_WOC | MLX90393_STATUS_ERROR)) == 0;
 }
 
+/**
+ * Checks for an MLX90393 at the given address.
+ *
+ * @param i2c_addr  The I2C address to probe.
+ * @param wire      The Wire object the sensor may be on.
+ *
+ * @return True if the device answered like an MLX90393.
+ */
+bool Adafruit_MLX90393::probe(uint8_t i2c_addr, TwoWire *wire) {
+  attach(i2c_addr, wire);
+
+  /* Anything at the address must first ACK and accept a mode exit... */
+  if (!exitMode()) {
+    return false;
+  }
+
+  /* ...and then report idle and error-free on a NOP. RESET is allowed:
+   * a part that has just powered up still reports it. */
+  uint8_t tx[1] = {MLX90393_REG_NOP};
+  const uint8_t status = transceive(tx, sizeof(tx), NULL, 0, 0);
+  return (status & (MLX90393_STATUS_BURSTMODE | MLX90393_STATUS_WOC |
+                    MLX90393_STATUS_SMMODE | MLX90393_STATUS_ERROR)) == 0;
+}
+
 /**
  * Perform a soft reset
  * @return True if the operation succeeded, otherwise false.
@@ -94,12 +202,33 @@ bool Adafruit_MLX90393::reset(void) {
   uint8_t tx[1] = {MLX90393_REG_RT};
 
   /* Perform the transaction. */
-  if (transceive(tx, sizeof(tx), NULL, 0, 5) != MLX90393_STATUS_RESET) {
+  if (transceive(tx, sizeof(tx), NULL, 0, MLX90393_RESET_MS) !=
+      MLX90393_STATUS_RESET) {
     return false;
   }
   return true;
 }
 
+/**
+ * Exits any mode and sends a soft reset without waiting for it.
+ * @return True if both commands were accepted.
+ */
+bool Adafruit_MLX90393::startReset(void) {
+  if (!exitMode()) {
+    return false;
+  }
+  uint8_t tx[1] = {MLX90393_REG_RT};
+  return writeCommand(tx, sizeof(tx));
+}
+
+/**
+ * Checks that a reset started with startReset completed.
+ * @return True if the sensor reports the reset.
+ */
+bool Adafruit_MLX90393::finishReset(void) {
+  return readStatus() == MLX90393_STATUS_RESET;
+}
+
 /**
  * Sets the sensor gain to the specified level.
  * @param gain  The gain level to set.
@@ -190,6 +319,15 @@ Adafruit_MLX90393::getResolution(enum mlx90393_axis axis) {
   return _res_x;  // I guess?
 }
 
+/**
+ * Gets the scale from counts to uT for one axis.
+ * @param axis  The magnetic axis.
+ * @return uT per count at the current gain and resolution.
+ */
+float Adafruit_MLX90393::getSensitivity(mlx90393_axis_t axis) const {
+  return mlx90393_lsb_lookup[0][_gain][resFromAxis(axis)][axis == MLX90393_Z];
+}
+
 /**
  * Sets the digital filter.
  * @param filter The digital filter setting.
@@ -239,6 +377,32 @@ enum mlx90393_oversampling Adafruit_MLX90393::getOversampling(void) {
   return _osr;
 }
 
+/**
+ * Sets the temperature channel oversampling (OSR2).
+ * @param oversampling The oversampling value to use.
+ * @return True if the operation succeeded, otherwise false.
+ */
+bool Adafruit_MLX90393::setTemperatureOversampling(
+    enum mlx90393_oversampling oversampling) {
+  _osr2 = oversampling;
+
+  uint16_t data = 0;
+  readRegister(MLX90393_CONF3, &data);
+
+  data &= ~0x1800;
+  data |= oversampling << 11;
+
+  return writeRegister(MLX90393_CONF3, data);
+}
+
+/**
+ * Gets the current temperature oversampling setting.
+ * @return An enum containing the current OSR2 setting.
+ */
+enum mlx90393_oversampling Adafruit_MLX90393::getTemperatureOversampling(void) {
+  return _osr2;
+}
+
 /**
  * Sets the TRIG_INT pin to the specified function.
  *
@@ -262,7 +426,74 @@ bool Adafruit_MLX90393::setTrigInt(bool state) {
   return writeRegister(MLX90393_CONF2, data);
 }
 
+/**
+ * Enables or disables on-chip temperature compensation (TCMP_EN).
+ *
+ * @param enable  True to let the chip compensate the magnetic axes.
+ *
+ * @return True if the operation succeeded, otherwise false.
+ */
+bool Adafruit_MLX90393::setTemperatureCompensation(bool enable) {
+  uint16_t data = 0;
+  if (!readRegister(MLX90393_CONF2, &data)) {
+    return false;
+  }
+
+  data &= ~MLX90393_TCMP_EN;
+  if (enable) {
+    data |= MLX90393_TCMP_EN;
+  }
+
+  if (!writeRegister(MLX90393_CONF2, data)) {
+    return false;
+  }
+  _tcmp_en = enable;
+  return true;
+}
+
+/**
+ * Gets the current temperature compensation setting.
+ * @return True if temperature compensation is enabled.
+ */
+bool Adafruit_MLX90393::getTemperatureCompensation(void) const {
+  return _tcmp_en;
+}
+
+/**
+ * Sets the sensitivity drift coefficients (CONF4).
+ *
+ * @param sens_tc_lt  Coefficient used below 35 degrees C.
+ * @param sens_tc_ht  Coefficient used above 35 degrees C.
+ *
+ * @return True if the operation succeeded, otherwise false.
+ */
+bool Adafruit_MLX90393::setSensitivityTC(uint8_t sens_tc_lt,
+                                         uint8_t sens_tc_ht) {
+  return writeRegister(MLX90393_CONF4,
+                       ((uint16_t)sens_tc_ht << 8) | sens_tc_lt);
+}
+
+/**
+ * Reads back the sensitivity drift coefficients (CONF4).
+ *
+ * @param sens_tc_lt  Where the low-temperature coefficient is stored.
+ * @param sens_tc_ht  Where the high-temperature coefficient is stored.
+ *
+ * @return True if the operation succeeded, otherwise false.
+ */
+bool Adafruit_MLX90393::getSensitivityTC(uint8_t *sens_tc_lt,
+                                         uint8_t *sens_tc_ht) {
+  uint16_t data = 0;
+  if (!readRegister(MLX90393_CONF4, &data)) {
+    return false;
+  }
+  *sens_tc_lt = data & 0xFF;
+  *sens_tc_ht = data >> 8;
+  return true;
+}
+
 bool Adafruit_MLX90393::startBurstMode(uint8_t axes) {
+  _conv_start_known = false;
   uint8_t tx[1] = {
       static_cast<uint8_t>(MLX90393_REG_SB | axes),
   };
@@ -293,16 +524,59 @@ bool Adafruit_MLX90393::setBurstRate(int delay_ms) {
 }
 
 /**
- * Begin a single measurement on all axes
+ * Configures the thresholds and starts wake-on-change mode.
+ *
+ * @param axes        ZYXT bit mask of the axes to watch.
+ * @param thresholds  Per-axis change thresholds, in counts.
+ * @param mode        Compare against the first or the previous measurement.
+ *
+ * @return True if the sensor entered wake-on-change mode.
+ */
+bool Adafruit_MLX90393::startWakeOnChange(
+    uint8_t axes, const mlx90393_woc_thresholds_t &thresholds,
+    mlx90393_woc_mode_t mode) {
+  _conv_start_known = false;
+  if (!writeRegister(MLX90393_WOXY_THRESHOLD, thresholds.xy) ||
+      !writeRegister(MLX90393_WOZ_THRESHOLD, thresholds.z) ||
+      !writeRegister(MLX90393_WOT_THRESHOLD, thresholds.t)) {
+    return false;
+  }
+
+  uint16_t data = 0;
+  if (!readRegister(MLX90393_CONF2, &data)) {
+    return false;
+  }
+  // Route change events to the INT pin.
+  data |= 0x8000;
+  data &= ~MLX90393_WOC_DIFF;
+  if (mode == MLX90393_WOC_DIFFERENTIAL) {
+    data |= MLX90393_WOC_DIFF;
+  }
+  if (!writeRegister(MLX90393_CONF2, data)) {
+    return false;
+  }
+
+  uint8_t tx[1] = {static_cast<uint8_t>(MLX90393_REG_SW | axes)};
+  const uint8_t status = transceive(tx, sizeof(tx), NULL, 0, 0);
+  return (status & MLX90393_STATUS_WOC) && !(status & MLX90393_STATUS_ERROR);
+}
+
+/**
+ * Begin a single measurement on the selected axes
+ *
+ * @param axes  ZYXT bit mask of the axes to convert.
  *
  * @return True on command success
  */
-bool Adafruit_MLX90393::startSingleMeasurement(void) {
-  uint8_t tx[1] = {MLX90393_REG_SM | MLX90393_AXIS_ALL};
+bool Adafruit_MLX90393::startSingleMeasurement(uint8_t axes) {
+  uint8_t tx[1] = {static_cast<uint8_t>(MLX90393_REG_SM | axes)};
 
   /* Set the device to single measurement mode */
+  const uint32_t start_us = micros();
   uint8_t stat = transceive(tx, sizeof(tx), NULL, 0, 0);
   if (!(stat & MLX90393_STATUS_ERROR) || (stat == MLX90393_STATUS_SMMODE)) {
+    _conv_start_us = start_us;
+    _conv_start_known = true;
     return true;
   }
   return false;
@@ -318,47 +592,19 @@ bool Adafruit_MLX90393::startSingleMeasurement(void) {
  * @return True on command success
  */
 bool Adafruit_MLX90393::readMeasurement(float *x, float *y, float *z) {
-  uint8_t tx[1] = {MLX90393_REG_RM | MLX90393_AXIS_ALL};
-  uint8_t rx[6] = {0};
-
-  /* Read a single data sample. */
-  if (transceive(tx, sizeof(tx), rx, sizeof(rx), 0) & MLX90393_STATUS_ERROR) {
+  float xyz[3];
+  if (!readMeasurement(MLX90393_AXIS_ALL, xyz)) {
     return false;
   }
-
-  int16_t xi, yi, zi;
-
-  /* Convert data to uT and float. */
-  xi = (rx[0] << 8) | rx[1];
-  yi = (rx[2] << 8) | rx[3];
-  zi = (rx[4] << 8) | rx[5];
-
-  if (_res_x == MLX90393_RES_18)
-    xi -= 0x8000;
-  if (_res_x == MLX90393_RES_19)
-    xi -= 0x4000;
-  if (_res_y == MLX90393_RES_18)
-    yi -= 0x8000;
-  if (_res_y == MLX90393_RES_19)
-    yi -= 0x4000;
-  if (_res_z == MLX90393_RES_18)
-    zi -= 0x8000;
-  if (_res_z == MLX90393_RES_19)
-    zi -= 0x4000;
-
-  *x = (float)xi * mlx90393_lsb_lookup[0][_gain][_res_x][0];
-  *y = (float)yi * mlx90393_lsb_lookup[0][_gain][_res_y][0];
-  *z = (float)zi * mlx90393_lsb_lookup[0][_gain][_res_z][1];
-
+  *x = xyz[0];
+  *y = xyz[1];
+  *z = xyz[2];
   return true;
 }
 
 bool Adafruit_MLX90393::readMeasurement(uint8_t axes, std::span<float> result) {
-  if (axes & MLX90393_T) {
-    return false;
-  }
   const int naxes = std::popcount(axes);
-  if (naxes > result.size()) {
+  if ((axes & ~MLX90393_AXIS_MASK) || (size_t)naxes > result.size()) {
     return false;
   }
 
@@ -371,17 +617,78 @@ bool Adafruit_MLX90393::readMeasurement(uint8_t axes, std::span<float> result) {
 
   int result_index = 0;
   std::span<const uint8_t> rx_span(rx);
-  for (auto axis : {MLX90393_X, MLX90393_Y, MLX90393_Z}) {
+  for (auto axis : {MLX90393_T, MLX90393_X, MLX90393_Y, MLX90393_Z}) {
     if ((axes & axis) == 0) {
       continue;
     }
-    const int16_t raw = (rx_span[0] << 8) | rx_span[1];
-    result[result_index++] = measurementToFloat(axis, raw);
+    const uint16_t raw = (rx_span[0] << 8) | rx_span[1];
+    if (axis == MLX90393_T) {
+      result[result_index++] = temperatureToFloat(raw);
+    } else {
+      result[result_index++] = measurementToFloat(axis, raw);
+    }
     rx_span = rx_span.subspan(2);
   }
   return true;
 }
 
+/**
+ * Reads a measurement and keeps the raw counts, status and clipping flags.
+ *
+ * @param axes    ZYXT bit mask of the axes to read.
+ * @param sample  Where the decoded sample is stored.
+ *
+ * @return True on command success
+ */
+bool Adafruit_MLX90393::readMeasurement(uint8_t axes,
+                                        mlx90393_sample_t *sample) {
+  /* rx holds at most four words; other bits would overrun it. */
+  if (axes & ~MLX90393_AXIS_MASK) {
+    return false;
+  }
+  uint8_t tx[1] = {static_cast<uint8_t>(MLX90393_REG_RM | axes)};
+  uint8_t rx[8];
+  sample->axes = axes;
+  sample->saturated = 0;
+  const uint32_t half_tconv_us = getConversionTimeUs(axes) / 2;
+  sample->timestamp_us = _conv_start_known ? _conv_start_us + half_tconv_us
+                                           : micros() - half_tconv_us;
+  sample->status =
+      transceive(tx, sizeof(tx), rx, 2 * std::popcount(axes), 0);
+  /* Keep the conversion start for the retry if it just wasn't ready. */
+  if (!mlx90393_status_not_ready(sample->status)) {
+    _conv_start_known = false;
+  }
+  if (sample->status & MLX90393_STATUS_ERROR) {
+    return false;
+  }
+
+  const uint8_t *word = rx;
+  for (auto axis : {MLX90393_T, MLX90393_X, MLX90393_Y, MLX90393_Z}) {
+    if ((axes & axis) == 0) {
+      continue;
+    }
+    const int slot = std::countr_zero((uint8_t)axis);
+    const uint16_t raw = (word[0] << 8) | word[1];
+    word += 2;
+    if (axis == MLX90393_T) {
+      sample->counts[slot] = raw;
+      sample->value[slot] = temperatureToFloat(raw);
+      continue;
+    }
+    const mlx90393_resolution res = resFromAxis(axis);
+    const int32_t counts = rawToCounts(res, raw);
+    const int32_t limit = mlx90393_counts_limit[res];
+    if (counts >= limit || counts < -limit) {
+      sample->saturated |= axis;
+    }
+    sample->counts[slot] = counts;
+    sample->value[slot] =
+        (float)counts * mlx90393_lsb_lookup[0][_gain][res][axis == MLX90393_Z];
+  }
+  return true;
+}
+
 mlx90393_resolution Adafruit_MLX90393::resFromAxis(mlx90393_axis_t axis) const {
   switch (axis) {
     case MLX90393_X:
@@ -396,16 +703,31 @@ mlx90393_resolution Adafruit_MLX90393::resFromAxis(mlx90393_axis_t axis) const {
   }
 }
 
+int32_t Adafruit_MLX90393::rawToCounts(mlx90393_resolution res,
+                                       uint16_t raw) const {
+  // RES_16/17 are two's complement unless temperature compensation is on, in
+  // which case every resolution is reported unsigned with a fixed offset.
+  if (res == MLX90393_RES_19) {
+    return (int32_t)raw - 0x4000;
+  }
+  if (res == MLX90393_RES_18 || _tcmp_en) {
+    return (int32_t)raw - 0x8000;
+  }
+  return (int16_t)raw;
+}
+
 float Adafruit_MLX90393::measurementToFloat(mlx90393_axis_t axis,
-                                            int16_t raw) const {
+                                            uint16_t raw) const {
   const mlx90393_resolution res = resFromAxis(axis);
-  if (res == MLX90393_RES_18) {
-    raw -= 0x8000;
-  } else if (res == MLX90393_RES_19) {
-    raw -= 0x4000;
-  }
   const bool is_z = axis == MLX90393_Z;
-  return (float)raw * mlx90393_lsb_lookup[0][_gain][res][is_z];
+  return (float)rawToCounts(res, raw) *
+         mlx90393_lsb_lookup[0][_gain][res][is_z];
+}
+
+float Adafruit_MLX90393::temperatureToFloat(uint16_t raw) const {
+  // T is unsigned and centred on the factory-trimmed TREF value.
+  return MLX90393_TEMP_OFFSET +
+         ((int32_t)raw - (int32_t)_tref) / (float)MLX90393_TEMP_LSB;
 }
 
 /**
@@ -418,24 +740,261 @@ float Adafruit_MLX90393::measurementToFloat(mlx90393_axis_t axis,
  * @return True if the operation succeeded, otherwise false.
  */
 bool Adafruit_MLX90393::readData(float *x, float *y, float *z) {
-  if (!startSingleMeasurement())
+  if (!startSingleMeasurement(MLX90393_AXIS_ALL))
     return false;
-  // See MLX90393 Getting Started Guide for fancy formula
-  // tconv = f(OSR, DIG_FILT, OSR2, ZYXT)
-  // For now, using Table 18 from datasheet
-  // Without +10ms delay measurement doesn't always seem to work
-  delay(mlx90393_tconv[_dig_filt][_osr] + 10);
+  delay(getConversionTimeUs(MLX90393_AXIS_ALL) / 1000 +
+        MLX90393_TCONV_MARGIN_MS);
   return readMeasurement(x, y, z);
 }
 
 bool Adafruit_MLX90393::readData(uint8_t axes, std::span<float> result) {
-  if (!startSingleMeasurement()) {
+  if (!startSingleMeasurement(axes)) {
     return false;
   }
-  delay(mlx90393_tconv[_dig_filt][_osr] + 10);
+  delay(getConversionTimeUs(axes) / 1000 + MLX90393_TCONV_MARGIN_MS);
   return readMeasurement(axes, result);
 }
 
+bool Adafruit_MLX90393::readData(uint8_t axes, mlx90393_sample_t *sample) {
+  if (!startSingleMeasurement(axes)) {
+    return false;
+  }
+  delay(getConversionTimeUs(axes) / 1000 + MLX90393_TCONV_MARGIN_MS);
+  return readMeasurement(axes, sample);
+}
+
+/**
+ * Starts a single measurement without waiting for it to complete.
+ *
+ * @param axes  ZYXT bit mask of the axes to convert.
+ *
+ * @return True if the SM command was accepted.
+ */
+bool Adafruit_MLX90393::beginMeasurement(uint8_t axes) {
+  _meas_sample.axes = axes;
+  if (!startSingleMeasurement(axes)) {
+    _meas_state = MLX90393_MEAS_ERROR;
+    return false;
+  }
+  armMeasurement(_conv_start_us, axes);
+  return true;
+}
+
+/**
+ * Schedules the first read-back of a conversion started at start_us. The
+ * same rule serves SM and trigger edges: RM at the nominal conversion time,
+ * retried (see poll) until MLX90393_TCONV_MARGIN_MS later.
+ */
+void Adafruit_MLX90393::armMeasurement(uint32_t start_us, uint8_t axes) {
+  _meas_sample.axes = axes;
+  _meas_deadline_us = start_us + getConversionTimeUs(axes);
+  _meas_timeout_us = _meas_deadline_us + MLX90393_TCONV_MARGIN_MS * 1000;
+  _meas_state = MLX90393_MEAS_CONVERTING;
+}
+
+/**
+ * Advances the non-blocking measurement. Never waits.
+ *
+ * @return The state after this call.
+ */
+mlx90393_meas_state_t Adafruit_MLX90393::poll(void) {
+  if (_meas_state != MLX90393_MEAS_CONVERTING) {
+    return _meas_state;
+  }
+  // Signed difference so that micros() wrapping around is harmless.
+  if ((int32_t)(micros() - _meas_deadline_us) < 0) {
+    return _meas_state;
+  }
+  if (readMeasurement(_meas_sample.axes, &_meas_sample)) {
+    _meas_state = MLX90393_MEAS_READY;
+  } else if (mlx90393_status_not_ready(_meas_sample.status) &&
+             (int32_t)(micros() - _meas_timeout_us) < 0) {
+    _meas_deadline_us = micros() + MLX90393_RETRY_US;
+  } else {
+    _meas_state = MLX90393_MEAS_ERROR;
+  }
+  return _meas_state;
+}
+
+/**
+ * Collects the result of a non-blocking measurement once it is ready.
+ *
+ * @param result  One value per measured axis, in T, X, Y, Z order.
+ *
+ * @return True if a result was available and copied out.
+ */
+bool Adafruit_MLX90393::tryGetResult(std::span<float> result) {
+  if (poll() != MLX90393_MEAS_READY) {
+    return false;
+  }
+  if ((size_t)std::popcount(_meas_sample.axes) > result.size()) {
+    _meas_state = MLX90393_MEAS_ERROR;
+    return false;
+  }
+  int result_index = 0;
+  for (int slot = 0; slot < 4; slot++) {
+    if (_meas_sample.axes & (1 << slot)) {
+      result[result_index++] = _meas_sample.value[slot];
+    }
+  }
+  _meas_state = MLX90393_MEAS_IDLE;
+  return true;
+}
+
+/**
+ * Collects the result of a non-blocking measurement once it is ready.
+ *
+ * @param sample  Where the decoded sample is stored.
+ *
+ * @return True if a result was available and copied out.
+ */
+bool Adafruit_MLX90393::tryGetResult(mlx90393_sample_t *sample) {
+  if (poll() != MLX90393_MEAS_READY) {
+    return false;
+  }
+  *sample = _meas_sample;
+  _meas_state = MLX90393_MEAS_IDLE;
+  return true;
+}
+
+/**
+ * Waits for a non-blocking measurement to complete and collects it.
+ *
+ * @param sample  Where the decoded sample is stored.
+ *
+ * @return True if the measurement succeeded.
+ */
+bool Adafruit_MLX90393::waitForResult(mlx90393_sample_t *sample) {
+  while (poll() == MLX90393_MEAS_CONVERTING) {
+    mlx90393_wait_until(_meas_deadline_us);
+  }
+  return tryGetResult(sample);
+}
+
+/**
+ * Enables the TRIG input and waits in burst mode for trigger edges.
+ *
+ * @param axes  ZYXT bit mask of the axes converted on every edge.
+ *
+ * @return True if the sensor accepted the configuration.
+ */
+bool Adafruit_MLX90393::startExternalTrigger(uint8_t axes) {
+  uint16_t data = 0;
+  if (!readRegister(MLX90393_CONF2, &data)) {
+    return false;
+  }
+  // TRIG_INT = 0 selects TRIG; EXT_TRG lets it start conversions.
+  data &= ~0x8000;
+  data |= MLX90393_EXT_TRG;
+  if (!writeRegister(MLX90393_CONF2, data)) {
+    return false;
+  }
+  _trig_axes = axes;
+  _meas_state = MLX90393_MEAS_IDLE;
+  return startBurstMode(axes);
+}
+
+/**
+ * Tells the driver a trigger edge was issued, arming the non-blocking read.
+ *
+ * @param edge_us  micros() at the trigger edge.
+ */
+void Adafruit_MLX90393::markTriggered(uint32_t edge_us) {
+  _conv_start_us = edge_us;
+  _conv_start_known = true;
+  armMeasurement(edge_us, _trig_axes);
+}
+
+/**
+ * Leaves external trigger mode and disables the TRIG input.
+ *
+ * @return True if the operation succeeded, otherwise false.
+ */
+bool Adafruit_MLX90393::stopExternalTrigger(void) {
+  _meas_state = MLX90393_MEAS_IDLE;
+  if (!exitMode()) {
+    return false;
+  }
+  uint16_t data = 0;
+  if (!readRegister(MLX90393_CONF2, &data)) {
+    return false;
+  }
+  data &= ~MLX90393_EXT_TRG;
+  return writeRegister(MLX90393_CONF2, data);
+}
+
+/**
+ * Starts pipelined single measurements.
+ *
+ * @param axes  ZYXT bit mask of the axes to convert on every cycle.
+ *
+ * @return True if the first SM command was accepted.
+ */
+bool Adafruit_MLX90393::startPipelined(uint8_t axes) {
+  return beginMeasurement(axes);
+}
+
+/**
+ * Returns the outstanding pipelined sample and starts the next conversion.
+ *
+ * @param sample  Where the decoded sample is stored.
+ *
+ * @return True on success. On failure the pipeline must be restarted.
+ */
+bool Adafruit_MLX90393::readPipelined(mlx90393_sample_t *sample) {
+  if (!waitForResult(sample)) {
+    return false;
+  }
+  return beginMeasurement(sample->axes);
+}
+
+/**
+ * Returns the outstanding pipelined sample and starts the next conversion.
+ *
+ * @param result  One value per measured axis, in T, X, Y, Z order.
+ *
+ * @return True on success. On failure the pipeline must be restarted.
+ */
+bool Adafruit_MLX90393::readPipelined(std::span<float> result) {
+  mlx90393_sample_t sample;
+  if (!readPipelined(&sample) ||
+      (size_t)std::popcount(sample.axes) > result.size()) {
+    return false;
+  }
+  int result_index = 0;
+  for (int slot = 0; slot < 4; slot++) {
+    if (sample.axes & (1 << slot)) {
+      result[result_index++] = sample.value[slot];
+    }
+  }
+  return true;
+}
+
+/**
+ * Stops pipelined measurements, discarding the conversion in flight.
+ *
+ * @return True if the mode exit succeeded.
+ */
+bool Adafruit_MLX90393::stopPipelined(void) {
+  _meas_state = MLX90393_MEAS_IDLE;
+  return exitMode();
+}
+
+/**
+ * Computes how long a single measurement of the given axes takes.
+ *
+ * @param axes  ZYXT bit mask of the axes being converted.
+ *
+ * @return The conversion time in microseconds.
+ */
+uint32_t Adafruit_MLX90393::getConversionTimeUs(uint8_t axes) const {
+  // Temperature compensation needs T, so the chip converts it regardless.
+  if (_tcmp_en) {
+    axes |= MLX90393_T;
+  }
+  return mlx90393_conversion_time_us(_dig_filt, _osr, _osr2, axes);
+}
+
 bool Adafruit_MLX90393::writeRegister(uint8_t reg, uint16_t data) {
   uint8_t tx[4] = {
       MLX90393_REG_WR,
@@ -464,6 +1023,19 @@ bool Adafruit_MLX90393::readRegister(uint8_t reg, uint16_t *data) {
   return true;
 }
 
+/**
+ * Blocks until micros() reaches a deadline.
+ *
+ * @param deadline_us  The micros() value to wait for.
+ */
+void mlx90393_wait_until(uint32_t deadline_us) {
+  const int32_t remaining = deadline_us - micros();
+  if (remaining > 0) {
+    delay(remaining / 1000);
+    delayMicroseconds(remaining % 1000);
+  }
+}
+
 /**
  * Performs a full read/write transaction with the sensor.
  *
@@ -479,6 +1051,57 @@ bool Adafruit_MLX90393::readRegister(uint8_t reg, uint16_t *data) {
 uint8_t Adafruit_MLX90393::transceive(uint8_t *txbuf, uint8_t txlen,
                                       uint8_t *rxbuf, uint8_t rxlen,
                                       uint8_t interdelay) {
+  /* Hold a shared bus for this one command only, never across waits. */
+  if (_bus_lock) {
+    _bus_lock->lock();
+  }
+  const uint8_t status = transfer(txbuf, txlen, rxbuf, rxlen, interdelay);
+  if (_bus_lock) {
+    _bus_lock->unlock();
+  }
+  return status;
+}
+
+/**
+ * Sends a command without reading its status back.
+ */
+bool Adafruit_MLX90393::writeCommand(uint8_t *txbuf, uint8_t txlen) {
+  if (_bus_lock) {
+    _bus_lock->lock();
+  }
+  _i2c->beginTransmission(_i2c_address);
+  _i2c->write(txbuf, txlen);
+  const bool ok = _i2c->endTransmission() == 0;
+  if (_bus_lock) {
+    _bus_lock->unlock();
+  }
+  return ok;
+}
+
+/**
+ * Reads the status byte of the previously sent command.
+ */
+uint8_t Adafruit_MLX90393::readStatus(void) {
+  if (_bus_lock) {
+    _bus_lock->lock();
+  }
+  uint8_t status = MLX90393_STATUS_ERROR;
+  if (_i2c->requestFrom(_i2c_address, (uint8_t)1) != 1 ||
+      _i2c->readBytes(&status, 1) != 1) {
+    status = MLX90393_STATUS_ERROR;
+  }
+  if (_bus_lock) {
+    _bus_lock->unlock();
+  }
+  return status & ~0b11;
+}
+
+/**
+ * Does the I2C work of transceive. The caller holds any bus lock.
+ */
+uint8_t Adafruit_MLX90393::transfer(uint8_t *txbuf, uint8_t txlen,
+                                    uint8_t *rxbuf, uint8_t rxlen,
+                                    uint8_t interdelay) {
   uint8_t status = 0;
   uint8_t i;
   uint8_t rxbuf2[rxlen + 2];
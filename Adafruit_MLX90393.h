@@ -18,6 +18,8 @@
 #ifndef ADAFRUIT_MLX90393_H
 #define ADAFRUIT_MLX90393_H
 
+#include <array>
+#include <bit>
 #include <cstdint>
 #include <span>
 
@@ -25,14 +27,27 @@
 #include "Wire.h"
 
 #define MLX90393_DEFAULT_ADDR (0x0C) /* Can also be 0x18, depending on IC */
+#define MLX90393_ADDR_FIRST (0x0C)   /**< Lowest address of any part option. */
+#define MLX90393_ADDR_LAST (0x1B)    /**< Highest address of any part option. */
 
 #define MLX90393_AXIS_ALL (0x0E)      /**< X+Y+Z axis bits for commands. */
+#define MLX90393_AXIS_MASK (0x0F)     /**< Every ZYXT bit; nothing else. */
 #define MLX90393_CONF1 (0x00)         /**< Gain */
 #define MLX90393_CONF2 (0x01)         /**< Burst, comm mode */
 #define MLX90393_CONF3 (0x02)         /**< Oversampling, filter, res. */
 #define MLX90393_CONF4 (0x03)         /**< Sensitivty drift. */
 #define MLX90393_GAIN_SHIFT (4)       /**< Left-shift for gain bits. */
+#define MLX90393_TCMP_EN (0x0400)     /**< CONF2 temperature compensation. */
+#define MLX90393_EXT_TRG (0x0800)     /**< CONF2 external trigger enable. */
+#define MLX90393_WOC_DIFF (0x1000)    /**< CONF2 wake-on-change reference. */
+#define MLX90393_WOXY_THRESHOLD (0x07) /**< X/Y wake-on-change threshold. */
+#define MLX90393_WOZ_THRESHOLD (0x08)  /**< Z wake-on-change threshold. */
+#define MLX90393_WOT_THRESHOLD (0x09)  /**< T wake-on-change threshold. */
 #define MLX90393_HALL_CONF (0x0C)     /**< Hall plate spinning rate adj. */
+#define MLX90393_TREF (0x24)          /**< Reference temperature register. */
+#define MLX90393_TREF_DEFAULT (46244) /**< Typical TREF, used until read. */
+#define MLX90393_TEMP_OFFSET (35.0)   /**< Temperature in C at TREF. */
+#define MLX90393_TEMP_LSB (45.2)      /**< Temperature counts per deg C. */
 #define MLX90393_STATUS_BURSTMODE (0b10000000)
 #define MLX90393_STATUS_WOC (0b01000000)
 #define MLX90393_STATUS_SMMODE (0b00100000)
@@ -80,8 +95,6 @@ typedef enum mlx90393_axis {
   MLX90393_X = 0b0010,
   MLX90393_Y = 0b0100,
   MLX90393_Z = 0b1000,
-  // Note that T is only partly supported because adafruit didn't implement it
-  // and I don't use it.
   MLX90393_T = 0b0001,
 } mlx90393_axis_t;
 
@@ -105,9 +118,70 @@ typedef enum mlx90393_oversampling {
   MLX90393_OSR_3,
 } mlx90393_oversampling_t;
 
+/** Reference that wake-on-change compares each measurement against. */
+typedef enum mlx90393_woc_mode {
+  MLX90393_WOC_ABSOLUTE,     /**< The first measurement after starting. */
+  MLX90393_WOC_DIFFERENTIAL, /**< The previous measurement. */
+} mlx90393_woc_mode_t;
+
+/** Wake-on-change thresholds, in the same counts as the measurements. */
+typedef struct mlx90393_woc_thresholds {
+  uint16_t xy; /**< Shared by X and Y. */
+  uint16_t z;  /**< Z axis. */
+  uint16_t t;  /**< Temperature. */
+} mlx90393_woc_thresholds_t;
+
+/** A complete measurement configuration, applied in one pass by
+ * applyConfig. Defaults match what begin_I2C sets up. */
+typedef struct mlx90393_config {
+  mlx90393_gain_t gain = MLX90393_GAIN_1X; /**< CONF1 GAIN_SEL. */
+  mlx90393_resolution_t res_x = MLX90393_RES_16; /**< CONF3 RES_X. */
+  mlx90393_resolution_t res_y = MLX90393_RES_16; /**< CONF3 RES_Y. */
+  mlx90393_resolution_t res_z = MLX90393_RES_16; /**< CONF3 RES_Z. */
+  mlx90393_filter_t filter = MLX90393_FILTER_7; /**< CONF3 DIG_FILT. */
+  mlx90393_oversampling_t osr = MLX90393_OSR_3; /**< CONF3 OSR. */
+  mlx90393_oversampling_t osr2 = MLX90393_OSR_0; /**< CONF3 OSR2. */
+  bool trig_int = false; /**< CONF2 TRIG_INT: true for INT, false for TRIG. */
+  bool tcmp_en = false;  /**< CONF2 TCMP_EN. */
+} mlx90393_config_t;
+
+/** Everything a driver instance needs to talk to one configured sensor,
+ * packed into 6 bytes so large arrays can keep one per sensor (see
+ * Adafruit_MLX90393_CompactArray). Filled by saveState, used by loadState;
+ * online belongs to the array and neither of them touches it. */
+typedef struct mlx90393_state {
+  uint16_t tref;       /**< TREF register, for temperature conversion. */
+  uint8_t addr : 7;    /**< 7-bit I2C address. */
+  uint8_t tcmp_en : 1; /**< Temperature compensation enabled. */
+  uint8_t gain : 3;    /**< mlx90393_gain_t. */
+  uint8_t filter : 3;  /**< mlx90393_filter_t. */
+  uint8_t osr : 2;     /**< mlx90393_oversampling_t. */
+  uint8_t res_x : 2;   /**< mlx90393_resolution_t of X. */
+  uint8_t res_y : 2;   /**< mlx90393_resolution_t of Y. */
+  uint8_t res_z : 2;   /**< mlx90393_resolution_t of Z. */
+  uint8_t osr2 : 2;    /**< mlx90393_oversampling_t of T. */
+  uint8_t online : 1;  /**< Cleared for a sensor that failed to come up. */
+} mlx90393_state_t;
+static_assert(sizeof(mlx90393_state_t) == 6, "mlx90393_state_t grew");
+
+/** Largest usable magnitude in counts (after offset removal) for each
+ * resolution setting. Outputs at or beyond this have clipped. */
+const int32_t mlx90393_counts_limit[4] = {32767, 32767, 32767, 16383};
+
+/** One decoded measurement. The arrays are indexed by the axis' bit position
+ * in the ZYXT mask: T = 0, X = 1, Y = 2, Z = 3. */
+typedef struct mlx90393_sample {
+  uint8_t status;    /**< Status byte returned with the data. */
+  uint8_t axes;      /**< ZYXT mask of the axes present in the sample. */
+  uint8_t saturated; /**< ZYXT mask of axes that hit the end of their range. */
+  int32_t counts[4]; /**< Offset-corrected counts (raw word for T). */
+  float value[4];    /**< uT for X/Y/Z, degrees C for T. */
+  uint32_t timestamp_us; /**< Estimated micros() at mid-conversion. */
+} mlx90393_sample_t;
+
 /** Lookup table to convert raw values to uT based on [HALLCONF][GAIN_SEL][RES].
  */
-const float mlx90393_lsb_lookup[2][8][4][2] = {
+constexpr float mlx90393_lsb_lookup[2][8][4][2] = {
 
     /* HALLCONF = 0xC (default) */
     {
@@ -149,7 +223,58 @@ const float mlx90393_lsb_lookup[2][8][4][2] = {
         {{0.157, 0.253}, {0.315, 0.507}, {0.629, 1.014}, {1.258, 2.027}},
     }};
 
-/** Lookup table for conversion time based on [DIF_FILT][OSR].
+/** Units a three-axis magnetic reading can be expressed in. */
+enum class mlx90393_unit {
+  COUNTS,     /**< Offset-corrected ADC counts. */
+  MICROTESLA, /**< uT, the native unit of mlx90393_lsb_lookup. */
+  GAUSS,      /**< 1 G = 100 uT. */
+};
+
+/** Multiplier from uT to the given unit. */
+template <mlx90393_unit Unit>
+inline constexpr float mlx90393_per_microtesla =
+    Unit == mlx90393_unit::GAUSS ? 0.01f : 1.0f;
+
+/** mlx90393_lsb_lookup pre-multiplied into the given unit, so that reading
+ * gauss costs the same single multiply per axis as reading uT. */
+template <mlx90393_unit Unit> struct mlx90393_lsb_table {
+  float v[2][8][4][2];
+
+  constexpr mlx90393_lsb_table() : v{} {
+    for (int h = 0; h < 2; h++)
+      for (int g = 0; g < 8; g++)
+        for (int r = 0; r < 4; r++)
+          for (int z = 0; z < 2; z++)
+            v[h][g][r][z] = mlx90393_lsb_lookup[h][g][r][z] *
+                            mlx90393_per_microtesla<Unit>;
+  }
+};
+
+template <mlx90393_unit Unit>
+inline constexpr mlx90393_lsb_table<Unit> mlx90393_lsb_in{};
+
+/** A three-axis reading tagged with its unit. */
+template <mlx90393_unit Unit, typename T = float> struct mlx90393_vec3 {
+  T x, y, z;
+};
+
+typedef mlx90393_vec3<mlx90393_unit::COUNTS, int32_t> Counts3;
+typedef mlx90393_vec3<mlx90393_unit::MICROTESLA> MicroTesla3;
+typedef mlx90393_vec3<mlx90393_unit::GAUSS> Gauss3;
+
+/** Converts between the two physical units. */
+constexpr Gauss3 toGauss(const MicroTesla3 &ut) {
+  constexpr float k = mlx90393_per_microtesla<mlx90393_unit::GAUSS>;
+  return {ut.x * k, ut.y * k, ut.z * k};
+}
+constexpr MicroTesla3 toMicroTesla(const Gauss3 &g) {
+  constexpr float k = 1.0f / mlx90393_per_microtesla<mlx90393_unit::GAUSS>;
+  return {g.x * k, g.y * k, g.z * k};
+}
+
+/** Lookup table for conversion time based on [DIF_FILT][OSR]. These are the
+ * datasheet Table 18 values for an XYZT conversion at OSR2 = 0; prefer
+ * mlx90393_conversion_time_us, which accounts for the axes and OSR2.
  */
 const float mlx90393_tconv[8][4] = {
     /* DIG_FILT = 0 */
@@ -170,6 +295,74 @@ const float mlx90393_tconv[8][4] = {
     {25.65, 50.61, 100.53, 200.37},
 };
 
+/** Fixed start-up time (TSTBY + TACTIVE) of every conversion, in us. */
+#define MLX90393_TCONV_OVERHEAD_US (240)
+/** Time the sensor needs after RT before it reports the reset, in ms. */
+#define MLX90393_RESET_MS (5)
+/** Extra wait after a single measurement before reading it back, in ms.
+ * Without it the measurement doesn't always seem to be ready. The
+ * non-blocking API reads back at the nominal conversion time instead and
+ * only gives up once this margin has passed too. */
+#define MLX90393_TCONV_MARGIN_MS (10)
+/** Interval between RM retries while a conversion isn't ready, in us. */
+#define MLX90393_RETRY_US (200)
+
+/**
+ * True if an RM status means "no data yet" rather than a failure: the
+ * sensor rejects RM with ERROR while a conversion is still running (or, in
+ * burst mode, when no new data is available), but keeps reporting its mode.
+ * A failed bus transaction reports ERROR alone.
+ */
+constexpr bool mlx90393_status_not_ready(uint8_t status) {
+  return (status & MLX90393_STATUS_ERROR) &&
+         (status & (MLX90393_STATUS_SMMODE | MLX90393_STATUS_BURSTMODE));
+}
+
+/** States of the non-blocking single-measurement API. */
+typedef enum mlx90393_meas_state {
+  MLX90393_MEAS_IDLE,       /**< No measurement in progress. */
+  MLX90393_MEAS_CONVERTING, /**< SM issued, conversion not finished yet. */
+  MLX90393_MEAS_READY,      /**< Result read back, waiting to be collected. */
+  MLX90393_MEAS_ERROR,      /**< SM or RM failed; begin a new measurement. */
+} mlx90393_meas_state_t;
+
+/**
+ * Conversion time of one SM/SB cycle in microseconds, from the datasheet:
+ *   TCONV  = TSTBY + TACTIVE + m * TCONVM + TCONVT (if T is selected)
+ *   TCONVM = 67 + 64 * 2^OSR * (2 + 2^DIG_FILT)
+ *   TCONVT = 67 + 192 * 2^OSR2
+ * where m is the number of magnetic axes in the ZYXT mask.
+ */
+constexpr uint32_t
+mlx90393_conversion_time_us(mlx90393_filter filter,
+                            mlx90393_oversampling osr,
+                            mlx90393_oversampling osr2, uint8_t axes) {
+  const uint32_t tconvm = 67 + (64u << osr) * (2 + (1u << filter));
+  const uint32_t tconvt = 67 + (192u << osr2);
+  const int m = std::popcount(static_cast<uint8_t>(axes & MLX90393_AXIS_ALL));
+  return MLX90393_TCONV_OVERHEAD_US + m * tconvm +
+         ((axes & MLX90393_T) ? tconvt : 0);
+}
+
+/** Blocks until micros() reaches deadline_us; returns at once if it has
+ * already passed (wrap-safe). Whole milliseconds go through delay(). */
+void mlx90393_wait_until(uint32_t deadline_us);
+
+class Adafruit_MLX90393_Measure;
+
+/**
+ * Lock for a bus shared by several driver instances used from different
+ * tasks. The driver holds it for exactly one command transaction, never
+ * across a conversion wait, so concurrent tasks only serialise on the bus
+ * itself. See Adafruit_MLX90393_RTOS.h for a FreeRTOS mutex version.
+ */
+class Adafruit_MLX90393_BusLock {
+ public:
+  virtual ~Adafruit_MLX90393_BusLock() {}
+  virtual void lock(void) = 0;
+  virtual void unlock(void) = 0;
+};
+
 /**
  * Driver for the Adafruit MLX90393 magnetometer breakout board.
  */
@@ -179,20 +372,107 @@ class Adafruit_MLX90393 {
   bool begin_I2C(uint8_t i2c_addr = MLX90393_DEFAULT_ADDR,
                  TwoWire *wire = &Wire);
 
+  // Points the instance at a sensor without talking to it, for bringing up
+  // several sensors together (see Adafruit_MLX90393_Array::begin).
+  void attach(uint8_t i2c_addr = MLX90393_DEFAULT_ADDR,
+              TwoWire *wire = &Wire);
+
+  // Copies the cached configuration and address to or from a compact
+  // state. loadState doesn't talk to the sensor and drops any measurement
+  // in progress.
+  void saveState(mlx90393_state_t *state) const;
+  void loadState(const mlx90393_state_t &state, TwoWire *wire);
+
+  // Writes every field of config with one read-modify-write per register
+  // and reloads TREF. Cheaper than calling the individual setters.
+  bool applyConfig(const mlx90393_config_t &config);
+
   bool reset(void);
   bool exitMode(void);
 
+  // Split form of reset() for resetting many sensors with a single wait:
+  // startReset exits any mode and sends RT without waiting, and finishReset
+  // checks the reset status once MLX90393_RESET_MS have passed.
+  bool startReset(void);
+  bool finishReset(void);
+
+  // Sets a lock shared by every instance on the same bus (may be NULL).
+  void setBusLock(Adafruit_MLX90393_BusLock *lock);
+
+  // Checks whether an MLX90393 answers at i2c_addr without configuring it:
+  // sends EX followed by NOP and checks that the status bytes look like an
+  // idle MLX90393. Starts the bus first, like begin_I2C and attach, so it
+  // can be the first call on wire. Leaves the instance pointed at i2c_addr.
+  bool probe(uint8_t i2c_addr, TwoWire *wire = &Wire);
+
   bool readMeasurement(float *x, float *y, float *z);
 
   // Reads the measurement from any of the four axes. One value will be placed
-  // into result for each selected axis. If result is null or not properly sized
-  // for the number of axes selected, the function will return false. This will
-  // also return false if the T axis is selected, since we don't know how to
-  // interpret it as a float. Additionally, any hardware errors will also result
-  // in a false return value.
+  // into result for each selected axis, in the order the chip returns them:
+  // T, X, Y, Z. Magnetic axes are in uT and T is in degrees C. If result is
+  // not properly sized for the number of axes selected, the function will
+  // return false. Additionally, any hardware errors will also result in a
+  // false return value.
   bool readMeasurement(uint8_t axes, std::span<float> result);
 
-  bool startSingleMeasurement(void);
+  // Like the above, but keeps the raw counts, the status byte and a per-axis
+  // saturation mask alongside the converted values. On a hardware error the
+  // status is still filled in and false is returned.
+  // The timestamp is the middle of the conversion window: derived from the
+  // SM command or trigger edge when the driver started the conversion, and
+  // otherwise (burst, wake-on-change) the latest possible midpoint before
+  // this read.
+  bool readMeasurement(uint8_t axes, mlx90393_sample_t *sample);
+
+  // Reads X/Y/Z into a unit-tagged vector (Counts3, MicroTesla3, Gauss3). The
+  // unit conversion is folded into the LSB table at compile time.
+  template <mlx90393_unit Unit, typename T>
+  bool readMeasurement(mlx90393_vec3<Unit, T> *result) {
+    uint8_t tx[1] = {MLX90393_REG_RM | MLX90393_AXIS_ALL};
+    uint8_t rx[6];
+    if (transceive(tx, sizeof(tx), rx, sizeof(rx), 0) &
+        MLX90393_STATUS_ERROR) {
+      return false;
+    }
+    const int32_t x = rawToCounts(_res_x, (rx[0] << 8) | rx[1]);
+    const int32_t y = rawToCounts(_res_y, (rx[2] << 8) | rx[3]);
+    const int32_t z = rawToCounts(_res_z, (rx[4] << 8) | rx[5]);
+    if constexpr (Unit == mlx90393_unit::COUNTS) {
+      *result = {x, y, z};
+    } else {
+      const auto &lsb = mlx90393_lsb_in<Unit>.v[0][_gain];
+      *result = {x * lsb[_res_x][0], y * lsb[_res_y][0], z * lsb[_res_z][1]};
+    }
+    return true;
+  }
+
+  // Compile-time variant of readMeasurement(axes, result), e.g.
+  //   std::array<float, 2> xz;
+  //   sensor.readMeasurement<MLX90393_X | MLX90393_Z>(xz);
+  // The command byte, rx length, decode order and per-axis scale selection are
+  // all fixed by Axes, so no per-call popcount, size check or axis loop runs.
+  template <uint8_t Axes>
+  bool readMeasurement(std::array<float, std::popcount(Axes)> &result) {
+    static_assert(Axes != 0 && (Axes & ~MLX90393_AXIS_MASK) == 0,
+                  "Axes is a ZYXT mask");
+    uint8_t tx[1] = {MLX90393_REG_RM | Axes};
+    uint8_t rx[2 * std::popcount(Axes)];
+    if (transceive(tx, sizeof(tx), rx, sizeof(rx), 0) &
+        MLX90393_STATUS_ERROR) {
+      return false;
+    }
+    if constexpr ((Axes & MLX90393_T) != 0)
+      decodeAxis<Axes, MLX90393_T>(rx, result);
+    if constexpr ((Axes & MLX90393_X) != 0)
+      decodeAxis<Axes, MLX90393_X>(rx, result);
+    if constexpr ((Axes & MLX90393_Y) != 0)
+      decodeAxis<Axes, MLX90393_Y>(rx, result);
+    if constexpr ((Axes & MLX90393_Z) != 0)
+      decodeAxis<Axes, MLX90393_Z>(rx, result);
+    return true;
+  }
+
+  bool startSingleMeasurement(uint8_t axes = MLX90393_AXIS_ALL);
 
   bool startBurstMode(uint8_t axes = MLX90393_AXIS_ALL);
 
@@ -201,42 +481,165 @@ class Adafruit_MLX90393 {
   // outside the allowed range will be clamped.
   bool setBurstRate(int delay_ms);
 
+  // Starts wake-on-change mode on axes. The sensor measures at the burst
+  // rate and raises the INT pin (TRIG_INT is switched to INT) when any
+  // selected axis moves by more than its threshold from the reference chosen
+  // by mode. Read the change with readMeasurement; exitMode stops it.
+  bool startWakeOnChange(uint8_t axes,
+                         const mlx90393_woc_thresholds_t &thresholds,
+                         mlx90393_woc_mode_t mode = MLX90393_WOC_DIFFERENTIAL);
+
   bool setGain(enum mlx90393_gain gain);
   enum mlx90393_gain getGain(void);
 
   bool setResolution(enum mlx90393_axis, enum mlx90393_resolution resolution);
   enum mlx90393_resolution getResolution(enum mlx90393_axis);
 
+  // uT per count of a magnetic axis at the current gain and resolution.
+  float getSensitivity(mlx90393_axis_t axis) const;
+
   bool setFilter(enum mlx90393_filter filter);
   enum mlx90393_filter getFilter(void);
 
   bool setOversampling(enum mlx90393_oversampling oversampling);
   enum mlx90393_oversampling getOversampling(void);
 
+  // Oversampling of the temperature channel (CONF3 OSR2).
+  bool setTemperatureOversampling(enum mlx90393_oversampling oversampling);
+  enum mlx90393_oversampling getTemperatureOversampling(void);
+
+  // Returns how long a single measurement of the given axes takes with the
+  // current filter and oversampling settings, in microseconds.
+  uint32_t getConversionTimeUs(uint8_t axes) const;
+
   bool setTrigInt(bool state);
+
+  // Enables the on-chip temperature compensation of the magnetic axes. While
+  // it is enabled the chip reports X/Y/Z as unsigned values offset by 0x8000
+  // (0x4000 at RES_19); readMeasurement accounts for this automatically.
+  bool setTemperatureCompensation(bool enable);
+  bool getTemperatureCompensation(void) const;
+
+  // Sets the sensitivity drift coefficients applied by temperature
+  // compensation below (SENS_TC_LT) and above (SENS_TC_HT) 35 degrees C.
+  bool setSensitivityTC(uint8_t sens_tc_lt, uint8_t sens_tc_ht);
+  bool getSensitivityTC(uint8_t *sens_tc_lt, uint8_t *sens_tc_ht);
   bool readData(float *x, float *y, float *z);
 
   bool readData(uint8_t axes, std::span<float> result);
+  bool readData(uint8_t axes, mlx90393_sample_t *sample);
+
+  // Non-blocking single measurement. beginMeasurement issues SM and returns
+  // immediately. poll() must then be called periodically; once the
+  // conversion time has passed it issues RM and moves to MLX90393_MEAS_READY.
+  // If the status byte says the data isn't ready yet it stays CONVERTING and
+  // retries every MLX90393_RETRY_US, moving to MLX90393_MEAS_ERROR on a bus
+  // error or once MLX90393_TCONV_MARGIN_MS have passed on top.
+  // tryGetResult returns false until the result is ready, then hands it over
+  // in T, X, Y, Z order and returns the state machine to idle. A result span
+  // too small for the measured axes is an error, not "not ready yet".
+  bool beginMeasurement(uint8_t axes = MLX90393_AXIS_ALL);
+  mlx90393_meas_state_t poll(void);
+  bool tryGetResult(std::span<float> result);
+  bool tryGetResult(mlx90393_sample_t *sample);
+
+  // Blocking form of the above: waits out the pending measurement (see
+  // poll) and collects it. Returns false if it ended in an error.
+  bool waitForResult(mlx90393_sample_t *sample);
+
+  // micros() value at which poll() next tries to read the measurement back.
+  uint32_t getMeasurementDeadline(void) const { return _meas_deadline_us; }
+
+  // External trigger mode: sets EXT_TRG, makes the TRIG_INT pin the TRIG
+  // input and enters burst mode on axes. Each rising edge on TRIG then starts
+  // one conversion, so several sensors (or a sensor and an encoder) sharing a
+  // trigger line sample at the same instant without any bus traffic. After
+  // driving the edge, call markTriggered so that poll/tryGetResult (and
+  // measure) read the conversion back once it is complete.
+  bool startExternalTrigger(uint8_t axes = MLX90393_AXIS_ALL);
+  void markTriggered(uint32_t edge_us);
+  bool stopExternalTrigger(void);
+
+  // Pipelined single measurements: startPipelined issues the first SM, then
+  // each readPipelined waits for the outstanding conversion, reads it back,
+  // immediately issues the next SM and returns the sample it just read. The
+  // sensor converts while the caller processes, giving close to burst-mode
+  // throughput with per-sample control of timing.
+  bool startPipelined(uint8_t axes = MLX90393_AXIS_ALL);
+  bool readPipelined(mlx90393_sample_t *sample);
+  bool readPipelined(std::span<float> result);
+  bool stopPipelined(void);
+
+  // Coroutine form of the above: `co_await sensor.measure(axes, result)`
+  // suspends for the conversion and yields true once result is filled in.
+  // Needs Adafruit_MLX90393_Coro.h, which defines the awaitable.
+  Adafruit_MLX90393_Measure measure(uint8_t axes, std::span<float> result);
+
+  template <mlx90393_unit Unit, typename T>
+  bool readData(mlx90393_vec3<Unit, T> *result) {
+    if (!startSingleMeasurement(MLX90393_AXIS_ALL)) {
+      return false;
+    }
+    delay(getConversionTimeUs(MLX90393_AXIS_ALL) / 1000 +
+          MLX90393_TCONV_MARGIN_MS);
+    return readMeasurement(result);
+  }
 
  private:
   mlx90393_resolution resFromAxis(mlx90393_axis_t axis) const;
-  float measurementToFloat(mlx90393_axis_t axis, int16_t raw) const;
+  int32_t rawToCounts(mlx90393_resolution res, uint16_t raw) const;
+  float measurementToFloat(mlx90393_axis_t axis, uint16_t raw) const;
+  float temperatureToFloat(uint16_t raw) const;
+
+  // Decodes one axis of an RM response for readMeasurement<Axes>. The axis'
+  // position in the response is the number of selected axes below it.
+  template <uint8_t Axes, mlx90393_axis_t Axis>
+  void decodeAxis(const uint8_t *rx,
+                  std::array<float, std::popcount(Axes)> &result) const {
+    constexpr int i = std::popcount(static_cast<uint8_t>(Axes & (Axis - 1)));
+    const uint16_t raw = (rx[2 * i] << 8) | rx[2 * i + 1];
+    if constexpr (Axis == MLX90393_T) {
+      result[i] = temperatureToFloat(raw);
+    } else {
+      const mlx90393_resolution res = Axis == MLX90393_X   ? _res_x
+                                      : Axis == MLX90393_Y ? _res_y
+                                                           : _res_z;
+      result[i] = (float)rawToCounts(res, raw) *
+                  mlx90393_lsb_lookup[0][_gain][res][Axis == MLX90393_Z];
+    }
+  }
 
   bool readRegister(uint8_t reg, uint16_t *data);
   bool writeRegister(uint8_t reg, uint16_t data);
   bool _init(void);
   uint8_t transceive(uint8_t *txbuf, uint8_t txlen, uint8_t *rxbuf = NULL,
                      uint8_t rxlen = 0, uint8_t interdelay = 10);
+  uint8_t transfer(uint8_t *txbuf, uint8_t txlen, uint8_t *rxbuf,
+                   uint8_t rxlen, uint8_t interdelay);
+  bool writeCommand(uint8_t *txbuf, uint8_t txlen);
+  void armMeasurement(uint32_t start_us, uint8_t axes);
+  uint8_t readStatus(void);
 
-  enum mlx90393_gain _gain;
-  enum mlx90393_resolution _res_x, _res_y, _res_z;
-  enum mlx90393_filter _dig_filt;
-  enum mlx90393_oversampling _osr;
-
+  mlx90393_sample_t _meas_sample = {};
   TwoWire *_i2c = nullptr;
+  Adafruit_MLX90393_BusLock *_bus_lock = nullptr;
+  uint32_t _conv_start_us = 0;
+  uint32_t _meas_deadline_us = 0;
+  uint32_t _meas_timeout_us = 0;
+
+  enum mlx90393_gain _gain = MLX90393_GAIN_1X;
+  enum mlx90393_resolution _res_x = MLX90393_RES_16, _res_y = MLX90393_RES_16,
+                           _res_z = MLX90393_RES_16;
+  enum mlx90393_filter _dig_filt = MLX90393_FILTER_7;
+  enum mlx90393_oversampling _osr = MLX90393_OSR_3;
+  enum mlx90393_oversampling _osr2 = MLX90393_OSR_0;
+  mlx90393_meas_state_t _meas_state = MLX90393_MEAS_IDLE;
+  uint16_t _tref = MLX90393_TREF_DEFAULT;
+
   uint8_t _i2c_address = 0;
-  int32_t _sensorID = 90393;
-  int _cspin;
+  uint8_t _trig_axes = 0;
+  bool _conv_start_known = false;
+  bool _tcmp_en = false;
 };
 
 #endif /* ADAFRUIT_MLX90393_H */
@@ -0,0 +1,463 @@
+/******************************************************************************
+  Multi-sensor support for the MLX90393 driver.
+
+  MIT license, all text above must be included in any redistribution
+ *****************************************************************************/
+#include "Adafruit_MLX90393_Array.h"
+
+/**
+ * Instantiates an empty sensor array.
+ */
+Adafruit_MLX90393_Array::Adafruit_MLX90393_Array(void) {}
+
+/**
+ * Adds an initialised sensor to the array.
+ *
+ * @param sensor  The sensor; must outlive the array.
+ *
+ * @return False if the array is already full.
+ */
+bool Adafruit_MLX90393_Array::addSensor(Adafruit_MLX90393 *sensor) {
+  if (_count == MLX90393_ARRAY_MAX) {
+    return false;
+  }
+  _health[_count] = Health();
+  _sensors[_count++] = sensor;
+  return true;
+}
+
+/**
+ * Resets and configures every sensor in the array together.
+ *
+ * @param config  Configuration applied to every sensor.
+ *
+ * @return Bit i set if sensor i failed to come up.
+ */
+uint32_t Adafruit_MLX90393_Array::begin(const mlx90393_config_t &config) {
+  /* Sensors that fail here get config applied when they recover. */
+  _config = config;
+  uint32_t failed = 0;
+  for (size_t i = 0; i < _count; i++) {
+    if (!_sensors[i]->startReset()) {
+      failed |= 1u << i;
+    }
+  }
+
+  delay(MLX90393_RESET_MS);
+
+  const uint32_t now_ms = millis();
+  for (size_t i = 0; i < _count; i++) {
+    if (!(failed & (1u << i)) && _sensors[i]->finishReset() &&
+        _sensors[i]->applyConfig(config)) {
+      _health[i] = Health();
+      continue;
+    }
+    failed |= 1u << i;
+    _health[i].failures = MLX90393_QUARANTINE_FAILURES - 1;
+    recordResult(i, false, now_ms);
+  }
+  return failed;
+}
+
+/**
+ * Scans the bus for MLX90393 parts and adds them to the array.
+ *
+ * @param wire     The Wire object to scan.
+ * @param storage  Driver instances to initialise, one per part found.
+ * @param cache    Optional result of a previous scan; updated in place.
+ *
+ * @return The number of sensors added.
+ */
+size_t Adafruit_MLX90393_Array::discover(TwoWire *wire,
+                                         std::span<Adafruit_MLX90393> storage,
+                                         mlx90393_discovery_cache_t *cache) {
+  const int naddrs = MLX90393_ADDR_LAST - MLX90393_ADDR_FIRST + 1;
+  Adafruit_MLX90393 prober;
+  uint16_t present = 0;
+
+  /* Fast path: the parts we found last time are all still there. */
+  bool cache_hit = false;
+  if (cache && cache->magic == MLX90393_DISCOVERY_MAGIC && cache->present) {
+    cache_hit = true;
+    for (int i = 0; i < naddrs && cache_hit; i++) {
+      if ((cache->present & (1u << i)) &&
+          !prober.probe(MLX90393_ADDR_FIRST + i, wire)) {
+        cache_hit = false;
+      }
+    }
+    present = cache->present;
+  }
+
+  if (!cache_hit) {
+    present = 0;
+    for (int i = 0; i < naddrs; i++) {
+      if (prober.probe(MLX90393_ADDR_FIRST + i, wire)) {
+        present |= 1u << i;
+      }
+    }
+  }
+
+  if (cache) {
+    cache->magic = MLX90393_DISCOVERY_MAGIC;
+    cache->present = present;
+  }
+
+  size_t added = 0;
+  /* Stop once full rather than bring up parts that can't be added. */
+  const size_t room =
+      std::min(storage.size(), (size_t)MLX90393_ARRAY_MAX - _count);
+  for (int i = 0; i < naddrs && added < room; i++) {
+    if (!(present & (1u << i))) {
+      continue;
+    }
+    Adafruit_MLX90393 &sensor = storage[added];
+    if (sensor.begin_I2C(MLX90393_ADDR_FIRST + i, wire) &&
+        addSensor(&sensor)) {
+      added++;
+    }
+  }
+  return added;
+}
+
+/**
+ * Measures every sensor once, overlapping their conversions.
+ *
+ * @param axes   ZYXT bit mask of the axes to convert.
+ * @param frame  Where the samples are stored.
+ *
+ * @return True if every sensor produced a sample.
+ */
+bool Adafruit_MLX90393_Array::readFrame(uint8_t axes,
+                                        mlx90393_frame_t *frame) {
+  if (_frames == 0) {
+    _stats_start_us = micros();
+  }
+
+  /* Issue every SM back to back. */
+  const uint32_t now_ms = millis();
+  uint32_t pending = 0;
+  for (size_t i = 0; i < _count; i++) {
+    if (!scheduled(i, now_ms)) {
+      continue;
+    }
+    if (_sensors[i]->beginMeasurement(axes)) {
+      pending |= 1u << i;
+    } else {
+      recordResult(i, false, now_ms);
+    }
+  }
+
+  /* Read each sensor back as its conversion completes. */
+  frame->valid = 0;
+  while (pending) {
+    size_t next = 0;
+    int32_t earliest = INT32_MAX;
+    const uint32_t now = micros();
+    for (size_t i = 0; i < _count; i++) {
+      if (!(pending & (1u << i))) {
+        continue;
+      }
+      const int32_t wait = _sensors[i]->getMeasurementDeadline() - now;
+      if (wait < earliest) {
+        earliest = wait;
+        next = i;
+      }
+    }
+    mlx90393_wait_until(_sensors[next]->getMeasurementDeadline());
+    /* Not ready yet: it has moved its deadline, so just pick again. */
+    if (_sensors[next]->poll() == MLX90393_MEAS_CONVERTING) {
+      continue;
+    }
+    const bool ok = _sensors[next]->tryGetResult(&frame->samples[next]);
+    if (ok) {
+      frame->valid |= 1u << next;
+    }
+    recordResult(next, ok, millis());
+    pending &= ~(1u << next);
+  }
+
+  frame->timestamp_us = _last_frame_us = micros();
+  _frames++;
+  return frame->valid == (1u << _count) - 1;
+}
+
+/**
+ * Decides whether a sensor takes part in this frame, re-probing it if it is
+ * quarantined and its back-off has expired.
+ */
+bool Adafruit_MLX90393_Array::scheduled(size_t index, uint32_t now_ms) {
+  Health &h = _health[index];
+  if (h.state != MLX90393_QUARANTINED) {
+    return true;
+  }
+  if ((int32_t)(now_ms - h.next_probe_ms) < 0) {
+    return false;
+  }
+  /* If it answers, restore its configuration (a part that browned out
+   * has lost it, while the driver still caches the old settings) and try
+   * it in the schedule again. The back-off only resets once it measures. */
+  if (_sensors[index]->exitMode() && _sensors[index]->applyConfig(_config)) {
+    h.state = MLX90393_DEGRADED;
+    h.failures = MLX90393_QUARANTINE_FAILURES - 1;
+    return true;
+  }
+  backOff(h, now_ms);
+  return false;
+}
+
+/**
+ * Schedules the next re-probe of a quarantined sensor and lengthens the
+ * wait after that.
+ */
+void Adafruit_MLX90393_Array::backOff(Health &h, uint32_t now_ms) {
+  h.next_probe_ms = now_ms + h.backoff_ms;
+  h.backoff_ms = std::min(2 * h.backoff_ms, MLX90393_REPROBE_MAX_MS);
+}
+
+/**
+ * Updates a sensor's health after a measurement attempt.
+ */
+void Adafruit_MLX90393_Array::recordResult(size_t index, bool ok,
+                                           uint32_t now_ms) {
+  Health &h = _health[index];
+  if (ok) {
+    h.state = MLX90393_HEALTHY;
+    h.failures = 0;
+    h.backoff_ms = MLX90393_REPROBE_MIN_MS;
+    return;
+  }
+  if (++h.failures < MLX90393_QUARANTINE_FAILURES) {
+    h.state = MLX90393_DEGRADED;
+    return;
+  }
+  h.state = MLX90393_QUARANTINED;
+  backOff(h, now_ms);
+}
+
+/**
+ * Reports the average acquisition rate.
+ *
+ * @return Frames per second since the statistics were last reset.
+ */
+float Adafruit_MLX90393_Array::framesPerSecond(void) const {
+  const uint32_t elapsed_us = _last_frame_us - _stats_start_us;
+  if (_frames == 0 || elapsed_us == 0) {
+    return 0;
+  }
+  return _frames * 1e6f / elapsed_us;
+}
+
+/**
+ * Restarts the frame rate statistics from the next frame.
+ */
+void Adafruit_MLX90393_Array::resetStats(void) { _frames = 0; }
+
+/**
+ * Instantiates an empty compact array.
+ *
+ * @param wire     The bus every sensor is on.
+ * @param storage  One state per sensor; must outlive the array.
+ */
+Adafruit_MLX90393_CompactArray::Adafruit_MLX90393_CompactArray(
+    TwoWire *wire, std::span<mlx90393_state_t> storage)
+    : _wire(wire), _states(storage) {}
+
+/**
+ * Adds a sensor to the array.
+ *
+ * @param i2c_addr  The sensor's I2C address.
+ *
+ * @return False if the storage is full.
+ */
+bool Adafruit_MLX90393_CompactArray::addSensor(uint8_t i2c_addr) {
+  if (_count == _states.size()) {
+    return false;
+  }
+  /* Built from the defaults, not the scratch driver, which still holds
+   * whichever sensor was selected last. */
+  const mlx90393_config_t config;
+  mlx90393_state_t &state = _states[_count++];
+  state.tref = MLX90393_TREF_DEFAULT;
+  state.addr = i2c_addr;
+  state.tcmp_en = config.tcmp_en;
+  state.gain = config.gain;
+  state.filter = config.filter;
+  state.osr = config.osr;
+  state.res_x = config.res_x;
+  state.res_y = config.res_y;
+  state.res_z = config.res_z;
+  state.osr2 = config.osr2;
+  state.online = true;
+  _wire->begin();
+  return true;
+}
+
+/**
+ * Resets and configures every sensor in the array together.
+ *
+ * @param config  Configuration applied to every sensor.
+ * @param failed  Optional per-sensor failure flags.
+ *
+ * @return The number of sensors that came up.
+ */
+size_t Adafruit_MLX90393_CompactArray::begin(const mlx90393_config_t &config,
+                                             std::span<bool> failed) {
+  for (size_t i = 0; i < failed.size(); i++) {
+    failed[i] = false;
+  }
+
+  /* A failed RT is caught by finishReset, so there's no need to track it. */
+  for (size_t i = 0; i < _count; i++) {
+    select(i).startReset();
+  }
+
+  delay(MLX90393_RESET_MS);
+
+  size_t ok = 0;
+  for (size_t i = 0; i < _count; i++) {
+    Adafruit_MLX90393 &sensor = select(i);
+    const bool up = sensor.finishReset() && sensor.applyConfig(config);
+    if (up) {
+      store();
+      ok++;
+    } else if (i < failed.size()) {
+      failed[i] = true;
+    }
+    _states[i].online = up;
+  }
+  return ok;
+}
+
+/**
+ * Loads one sensor into the shared driver.
+ *
+ * @param index  The sensor, in the order they were added.
+ *
+ * @return The shared driver.
+ */
+Adafruit_MLX90393 &Adafruit_MLX90393_CompactArray::select(size_t index) {
+  _driver.loadState(_states[index], _wire);
+  _selected = index;
+  return _driver;
+}
+
+/**
+ * Saves the shared driver's configuration back to the selected sensor.
+ */
+void Adafruit_MLX90393_CompactArray::store(void) {
+  _driver.saveState(&_states[_selected]);
+}
+
+/**
+ * Takes one measurement from a sensor.
+ *
+ * @param index   The sensor, in the order they were added.
+ * @param axes    ZYXT bit mask of the axes to convert.
+ * @param sample  Where the result is stored.
+ *
+ * @return True on success.
+ */
+bool Adafruit_MLX90393_CompactArray::readData(size_t index, uint8_t axes,
+                                              mlx90393_sample_t *sample) {
+  if (!_states[index].online) {
+    return false;
+  }
+  return select(index).readData(axes, sample);
+}
+
+/**
+ * Pairs two initialised sensors.
+ *
+ * @param a           The sensor whose reading is subtracted from.
+ * @param b           The sensor subtracted.
+ * @param baseline_m  Distance between the two sensors, in metres.
+ */
+Adafruit_MLX90393_Gradiometer::Adafruit_MLX90393_Gradiometer(
+    Adafruit_MLX90393 *a, Adafruit_MLX90393 *b, float baseline_m)
+    : _a(a), _b(b), _baseline_m(baseline_m) {}
+
+/**
+ * Sets the calibration of both sensors. Gains and offsets are both folded
+ * into the per-axis factors, so this takes effect on the next begin().
+ *
+ * @param a  Calibration of the first sensor.
+ * @param b  Calibration of the second sensor.
+ */
+void Adafruit_MLX90393_Gradiometer::setCalibration(const mlx90393_cal_t &a,
+                                                   const mlx90393_cal_t &b) {
+  _cal_a = a;
+  _cal_b = b;
+}
+
+/**
+ * Folds the scales and arms the trigger mode.
+ *
+ * @param trigger  Pulses the shared TRIG line, or NULL to use SM commands.
+ *
+ * @return True if both sensors were set up.
+ */
+bool Adafruit_MLX90393_Gradiometer::begin(void (*trigger)(void)) {
+  const mlx90393_axis_t axes[3] = {MLX90393_X, MLX90393_Y, MLX90393_Z};
+  for (int i = 0; i < 3; i++) {
+    _k_a[i] = _a->getSensitivity(axes[i]) * _cal_a.gain[i] / _baseline_m;
+    _k_b[i] = _b->getSensitivity(axes[i]) * _cal_b.gain[i] / _baseline_m;
+    _bias[i] = _cal_a.offset[i] * _k_a[i] - _cal_b.offset[i] * _k_b[i];
+  }
+
+  _trigger = trigger;
+  if (!_trigger) {
+    return true;
+  }
+  return _a->startExternalTrigger(MLX90393_AXIS_ALL) &&
+         _b->startExternalTrigger(MLX90393_AXIS_ALL);
+}
+
+/**
+ * Leaves external trigger mode if it was used.
+ *
+ * @return True if the operation succeeded, otherwise false.
+ */
+bool Adafruit_MLX90393_Gradiometer::end(void) {
+  if (!_trigger) {
+    return true;
+  }
+  _trigger = nullptr;
+  return _a->stopExternalTrigger() && _b->stopExternalTrigger();
+}
+
+/**
+ * Measures both sensors together and computes the gradient.
+ *
+ * @param gradient  Where the gradient is stored.
+ *
+ * @return True if both sensors were read.
+ */
+bool Adafruit_MLX90393_Gradiometer::read(mlx90393_gradient_t *gradient) {
+  /* Both paths read back by the same readiness rule (see poll). */
+  if (_trigger) {
+    const uint32_t edge_us = micros();
+    _trigger();
+    _a->markTriggered(edge_us);
+    _b->markTriggered(edge_us);
+  } else if (!_a->beginMeasurement(MLX90393_AXIS_ALL) ||
+             !_b->beginMeasurement(MLX90393_AXIS_ALL)) {
+    return false;
+  }
+
+  mlx90393_sample_t a, b;
+  if (!_a->waitForResult(&a) || !_b->waitForResult(&b)) {
+    return false;
+  }
+
+  /* counts[] is indexed by ZYXT bit, so X/Y/Z are slots 1 to 3. */
+  float g[3];
+  for (int i = 0; i < 3; i++) {
+    g[i] = a.counts[i + 1] * _k_a[i] - b.counts[i + 1] * _k_b[i] - _bias[i];
+  }
+  gradient->x = g[0];
+  gradient->y = g[1];
+  gradient->z = g[2];
+  gradient->timestamp_us =
+      a.timestamp_us + (int32_t)(b.timestamp_us - a.timestamp_us) / 2;
+  return true;
+}
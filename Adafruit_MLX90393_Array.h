@@ -0,0 +1,359 @@
+/******************************************************************************
+  Multi-sensor support for the MLX90393 driver.
+
+  Adafruit_MLX90393_Array drives several MLX90393 parts that share a bus
+  (addresses 0x0C-0x0F, 0x10-0x13, 0x14-0x17 and 0x18-0x1B, depending on the
+  part option and A0/A1 pins). Rather than running SM -> delay -> RM for one
+  sensor after another, it starts every conversion first and then reads each
+  sensor back as soon as its own conversion is complete, so the bus is only
+  idle while the last conversion finishes.
+
+  Adafruit_MLX90393_FrameAssembler resamples the timestamped samples of
+  several sensors onto a common tick, for algorithms (gradients,
+  localisation) that need simultaneous readings.
+
+  Adafruit_MLX90393_CompactArray keeps only a 6-byte mlx90393_state_t per
+  sensor and shares one driver instance and bus pointer between them, for
+  arrays too large to hold a full driver object per sensor.
+
+  Adafruit_MLX90393_Gradiometer pairs two sensors, samples them as close to
+  simultaneously as the hardware allows and returns the calibrated field
+  difference per metre, rejecting far-field interference.
+
+  MIT license, all text above must be included in any redistribution
+ *****************************************************************************/
+#ifndef ADAFRUIT_MLX90393_ARRAY_H
+#define ADAFRUIT_MLX90393_ARRAY_H
+
+#include <cstddef>
+#include <span>
+
+#include "Adafruit_MLX90393.h"
+
+#define MLX90393_ARRAY_MAX (8) /**< Most sensors one array holds. */
+
+#define MLX90393_DISCOVERY_MAGIC (0x9039) /**< Marks a valid cache. */
+
+#define MLX90393_QUARANTINE_FAILURES (3) /**< Failures before quarantine. */
+#define MLX90393_REPROBE_MIN_MS (100)     /**< First re-probe back-off. */
+#define MLX90393_REPROBE_MAX_MS (30000)   /**< Longest re-probe back-off. */
+
+/** Health of one sensor in an array. */
+typedef enum mlx90393_health {
+  MLX90393_HEALTHY,     /**< Last measurement succeeded. */
+  MLX90393_DEGRADED,    /**< Recent failures, still scheduled. */
+  MLX90393_QUARANTINED, /**< Skipped until a re-probe succeeds. */
+} mlx90393_health_t;
+
+/** Addresses found by discover(). Persist it (EEPROM, NVS, ...) and pass it
+ * back on the next boot to re-verify only the known addresses. */
+typedef struct mlx90393_discovery_cache {
+  uint16_t magic;   /**< MLX90393_DISCOVERY_MAGIC once filled in. */
+  uint16_t present; /**< Bit i set if a part answered at ADDR_FIRST + i. */
+} mlx90393_discovery_cache_t;
+
+/** One acquisition round across every sensor of an array. */
+typedef struct mlx90393_frame {
+  uint32_t valid;        /**< Bit i set if sensor i produced samples[i]. */
+  uint32_t timestamp_us; /**< micros() when the last sample was read. */
+  mlx90393_sample_t samples[MLX90393_ARRAY_MAX]; /**< Indexed like sensor(). */
+} mlx90393_frame_t;
+
+/**
+ * Interleaves single measurements across up to MLX90393_ARRAY_MAX sensors.
+ * The sensors are owned by the caller and must already be initialised.
+ */
+class Adafruit_MLX90393_Array {
+ public:
+  Adafruit_MLX90393_Array();
+
+  bool addSensor(Adafruit_MLX90393 *sensor);
+
+  // Brings up every added sensor at once; they only need to be attach()ed.
+  // All sensors are reset, a single MLX90393_RESET_MS wait covers them all,
+  // then config is applied to each in one sweep so that they end up
+  // identical. Returns a mask of the sensors that failed (0 on success);
+  // those are quarantined like sensors that fail in readFrame, and are only
+  // scheduled again once config has been applied to them. config also
+  // becomes the array's configuration (see setConfig).
+  uint32_t begin(const mlx90393_config_t &config = mlx90393_config_t());
+
+  // Finds the MLX90393 parts on wire, initialises one instance of storage
+  // per part with begin_I2C and adds it to the array. Returns how many were
+  // added. With a valid cache only the cached addresses are re-verified;
+  // if any of them is gone the full address range is probed again. The
+  // cache is updated with what was found. Starts the bus itself (see
+  // probe), so it can be the first call on wire.
+  size_t discover(TwoWire *wire, std::span<Adafruit_MLX90393> storage,
+                  mlx90393_discovery_cache_t *cache = nullptr);
+
+  size_t size(void) const { return _count; }
+  Adafruit_MLX90393 *sensor(size_t index) const { return _sensors[index]; }
+
+  // Starts a conversion of axes on every sensor, then reads each one back in
+  // the order their conversions complete. Returns true if every sensor
+  // produced a sample; frame->valid says which ones did otherwise.
+  // A sensor that fails MLX90393_QUARANTINE_FAILURES frames in a row is
+  // quarantined: it is left out of the schedule, so it no longer costs an
+  // I2C timeout per frame, and is re-probed with exponential back-off
+  // until it answers again. On answering it is re-configured with the
+  // array's configuration (see setConfig) before it is scheduled again.
+  bool readFrame(uint8_t axes, mlx90393_frame_t *frame);
+
+  // Configuration restored on sensors that recover from quarantine. Defaults
+  // to what begin_I2C sets up; set it if the sensors are configured
+  // differently.
+  void setConfig(const mlx90393_config_t &config) { _config = config; }
+
+  mlx90393_health_t health(size_t index) const {
+    return _health[index].state;
+  }
+
+  // Average frame rate since the first readFrame (or resetStats).
+  float framesPerSecond(void) const;
+  void resetStats(void);
+
+ private:
+  struct Health {
+    mlx90393_health_t state = MLX90393_HEALTHY;
+    uint8_t failures = 0;
+    uint16_t backoff_ms = MLX90393_REPROBE_MIN_MS;
+    uint32_t next_probe_ms = 0;
+  };
+
+  bool scheduled(size_t index, uint32_t now_ms);
+  void recordResult(size_t index, bool ok, uint32_t now_ms);
+  static void backOff(Health &h, uint32_t now_ms);
+
+  Adafruit_MLX90393 *_sensors[MLX90393_ARRAY_MAX];
+  Health _health[MLX90393_ARRAY_MAX];
+  size_t _count = 0;
+  mlx90393_config_t _config;
+
+  uint32_t _frames = 0;
+  uint32_t _stats_start_us = 0;
+  uint32_t _last_frame_us = 0;
+};
+
+/**
+ * Any number of sensors on one bus, each stored as an mlx90393_state_t in
+ * caller-provided storage. A single scratch driver is loaded with a
+ * sensor's state whenever that sensor is accessed, so the per-sensor cost is
+ * the state alone.
+ *
+ * The compact layout leaves out what Adafruit_MLX90393_Array keeps per
+ * sensor: there are no interleaved frames (readData measures one sensor at
+ * a time) and no health tracking, quarantine or re-probing. The only
+ * health state is the online flag that begin sets.
+ */
+class Adafruit_MLX90393_CompactArray {
+ public:
+  Adafruit_MLX90393_CompactArray(TwoWire *wire,
+                                 std::span<mlx90393_state_t> storage);
+
+  // Appends a sensor at i2c_addr without talking to it. Returns false if
+  // storage is full.
+  bool addSensor(uint8_t i2c_addr);
+
+  // Resets every sensor with one shared wait and applies config to each,
+  // like Adafruit_MLX90393_Array::begin. Sensors that don't come up are
+  // marked offline, and readData refuses them until a later begin brings
+  // them up. If failed is not empty, failed[i] is set for each of them.
+  // Returns how many came up.
+  size_t begin(const mlx90393_config_t &config = mlx90393_config_t(),
+               std::span<bool> failed = {});
+
+  size_t size(void) const { return _count; }
+  bool online(size_t index) const { return _states[index].online; }
+
+  // Loads sensor index into the shared driver and returns it. The driver
+  // stays valid until the next select; after changing the configuration
+  // through it, call store() to keep the change.
+  Adafruit_MLX90393 &select(size_t index);
+  void store(void);
+
+  // Takes one blocking measurement of axes on sensor index (see readData).
+  // Returns false without any bus traffic if the sensor is offline.
+  bool readData(size_t index, uint8_t axes, mlx90393_sample_t *sample);
+
+  void setBusLock(Adafruit_MLX90393_BusLock *lock) {
+    _driver.setBusLock(lock);
+  }
+
+ private:
+  TwoWire *_wire;
+  std::span<mlx90393_state_t> _states;
+  size_t _count = 0;
+  size_t _selected = 0;
+  Adafruit_MLX90393 _driver;
+};
+
+/** Per-sensor calibration, applied in the counts domain. */
+typedef struct mlx90393_cal {
+  int32_t offset[3] = {0, 0, 0};  /**< X/Y/Z zero offset, in counts. */
+  float gain[3] = {1.0, 1.0, 1.0}; /**< X/Y/Z relative gain correction. */
+} mlx90393_cal_t;
+
+/** First-order field gradient between the two sensors of a gradiometer. */
+typedef struct mlx90393_gradient {
+  float x, y, z;         /**< (A - B) / baseline, in uT per metre. */
+  uint32_t timestamp_us; /**< Estimated micros() at mid-conversion. */
+} mlx90393_gradient_t;
+
+/**
+ * Two sensors read as a gradiometer. Both are converted together, either
+ * from one shared TRIG edge (EXT_TRG) or by SM commands sent back to back,
+ * and the gradient is computed straight from raw counts with the LSB size,
+ * calibration and baseline folded into one factor per axis.
+ */
+class Adafruit_MLX90393_Gradiometer {
+ public:
+  Adafruit_MLX90393_Gradiometer(Adafruit_MLX90393 *a, Adafruit_MLX90393 *b,
+                                float baseline_m);
+
+  void setCalibration(const mlx90393_cal_t &a, const mlx90393_cal_t &b);
+
+  // Prepares both sensors. With a trigger function (which should pulse the
+  // TRIG line both sensors share), conversions start from that edge;
+  // without one, back-to-back SM commands are used. Call again after
+  // changing gain or resolution on either sensor.
+  bool begin(void (*trigger)(void) = nullptr);
+  bool end(void);
+
+  bool read(mlx90393_gradient_t *gradient);
+
+ private:
+  Adafruit_MLX90393 *_a, *_b;
+  float _baseline_m;
+  mlx90393_cal_t _cal_a, _cal_b;
+  void (*_trigger)(void) = nullptr;
+  /* Folded scales: uT per count * gain / baseline, per sensor and axis. */
+  float _k_a[3] = {0, 0, 0}, _k_b[3] = {0, 0, 0};
+  /* Folded offsets: offset_a * k_a - offset_b * k_b, per axis. */
+  float _bias[3] = {0, 0, 0};
+};
+
+/** Interpolation used by Adafruit_MLX90393_FrameAssembler. */
+typedef enum mlx90393_interp {
+  MLX90393_INTERP_LINEAR, /**< Between the two samples around the tick. */
+  MLX90393_INTERP_CUBIC,  /**< Cubic Hermite through four samples. */
+} mlx90393_interp_t;
+
+/**
+ * Resamples the X/Y/Z of NSensors sensors onto a common timebase. Keeps the
+ * last History timestamped samples per sensor (pushed in time order) and
+ * interpolates each sensor at the requested tick. Nothing is allocated:
+ * assemble writes into a caller-owned, reusable Frame.
+ */
+template <size_t NSensors, size_t History = 4>
+class Adafruit_MLX90393_FrameAssembler {
+  static_assert(History >= 2, "Interpolation needs at least two samples");
+  static_assert(NSensors >= 1 && NSensors <= 32,
+                "Frame::valid has one bit per sensor");
+
+ public:
+  /** All sensors at one instant. */
+  struct Frame {
+    uint32_t tick_us;           /**< The instant the field was resampled at. */
+    uint32_t valid;             /**< Bit i set if field[i] was bracketed. */
+    MicroTesla3 field[NSensors]; /**< X/Y/Z of each sensor at tick_us. */
+  };
+
+  // Adds a sample of sensor index. Samples without all of X, Y and Z are
+  // ignored.
+  void push(size_t index, const mlx90393_sample_t &sample) {
+    if (index >= NSensors || (sample.axes & MLX90393_AXIS_ALL) !=
+                                 MLX90393_AXIS_ALL) {
+      return;
+    }
+    Track &h = _history[index];
+    h.points[h.head] = {sample.timestamp_us, sample.value[1],
+                        sample.value[2], sample.value[3]};
+    h.head = (h.head + 1) % History;
+    if (h.count < History) {
+      h.count++;
+    }
+  }
+
+  // Adds every valid sample of an array frame.
+  void push(const mlx90393_frame_t &frame) {
+    for (size_t i = 0; i < NSensors && i < MLX90393_ARRAY_MAX; i++) {
+      if (frame.valid & (1u << i)) {
+        push(i, frame.samples[i]);
+      }
+    }
+  }
+
+  // Interpolates every sensor at tick_us into out. A sensor is only valid
+  // if it has samples on both sides of the tick; cubic interpolation falls
+  // back to one-sided tangents when the outer neighbours are missing.
+  // Returns true if every sensor is valid.
+  bool assemble(uint32_t tick_us, mlx90393_interp_t interp, Frame *out) const {
+    out->tick_us = tick_us;
+    out->valid = 0;
+    for (size_t i = 0; i < NSensors; i++) {
+      if (_history[i].interpolate(tick_us, interp, &out->field[i])) {
+        out->valid |= 1u << i;
+      }
+    }
+    return out->valid == UINT32_MAX >> (32 - NSensors);
+  }
+
+ private:
+  struct Point {
+    uint32_t t_us;
+    float x, y, z;
+  };
+
+  struct Track {
+    Point points[History];
+    size_t head = 0, count = 0;
+
+    // k-th oldest point.
+    const Point &at(size_t k) const {
+      return points[(head + History - count + k) % History];
+    }
+
+    bool interpolate(uint32_t tick_us, mlx90393_interp_t interp,
+                     MicroTesla3 *out) const {
+      // Find the pair (k, k + 1) that brackets the tick. Times are compared
+      // as signed offsets from the tick so that micros() can wrap.
+      for (size_t k = 0; k + 1 < count; k++) {
+        const Point &p1 = at(k), &p2 = at(k + 1);
+        const int32_t d1 = p1.t_us - tick_us, d2 = p2.t_us - tick_us;
+        if (d1 > 0 || d2 < 0 || d2 == d1) {
+          continue;
+        }
+        const float h = (float)(d2 - d1);
+        const float s = -d1 / h;
+        if (interp == MLX90393_INTERP_LINEAR) {
+          *out = {p1.x + s * (p2.x - p1.x), p1.y + s * (p2.y - p1.y),
+                  p1.z + s * (p2.z - p1.z)};
+          return true;
+        }
+
+        // Cubic Hermite with finite-difference tangents, scaled to the
+        // [p1, p2] interval so unevenly spaced samples are handled.
+        const Point *p0 = k > 0 ? &at(k - 1) : nullptr;
+        const Point *p3 = k + 2 < count ? &at(k + 2) : nullptr;
+        const float span0 = p0 ? (float)(int32_t)(p2.t_us - p0->t_us) : 0;
+        const float span3 = p3 ? (float)(int32_t)(p3->t_us - p1.t_us) : 0;
+        const float s2 = s * s, s3 = s2 * s;
+        const float h00 = 2 * s3 - 3 * s2 + 1, h10 = s3 - 2 * s2 + s;
+        const float h01 = -2 * s3 + 3 * s2, h11 = s3 - s2;
+        auto axis = [&](float Point::*c) {
+          const float m1 = p0 ? (p2.*c - p0->*c) * h / span0 : p2.*c - p1.*c;
+          const float m2 = p3 ? (p3->*c - p1.*c) * h / span3 : p2.*c - p1.*c;
+          return h00 * p1.*c + h10 * m1 + h01 * p2.*c + h11 * m2;
+        };
+        *out = {axis(&Point::x), axis(&Point::y), axis(&Point::z)};
+        return true;
+      }
+      return false;
+    }
+  };
+
+  Track _history[NSensors];
+};
+
+#endif /* ADAFRUIT_MLX90393_ARRAY_H */
@@ -0,0 +1,240 @@
+/******************************************************************************
+  C++20 coroutine support for the MLX90393 driver.
+
+  Lets acquisition logic for one or more sensors be written sequentially:
+
+    Adafruit_MLX90393_Task acquire(Adafruit_MLX90393 &a, Adafruit_MLX90393 &b) {
+      float xyz_a[3], xyz_b[3];
+      for (;;) {
+        if (co_await a.measure(MLX90393_AXIS_ALL, xyz_a) &&
+            co_await b.measure(MLX90393_AXIS_ALL, xyz_b)) {
+          ...
+        }
+        co_await mlx90393_sleep_us(5000);
+      }
+    }
+
+    Adafruit_MLX90393_Executor executor;
+    Adafruit_MLX90393_Task task = acquire(sensor_a, sensor_b);
+    executor.spawn(task);
+    ...
+    void loop() { executor.runOnce(); ... }
+
+  Suspended coroutines are parked on the executor with a micros() deadline
+  and resumed from runOnce(), so nothing blocks in delay(). The executor is
+  single-threaded and does not allocate; the coroutine frames themselves are
+  allocated by the compiler when a task is created.
+
+  MIT license, all text above must be included in any redistribution
+ *****************************************************************************/
+#ifndef ADAFRUIT_MLX90393_CORO_H
+#define ADAFRUIT_MLX90393_CORO_H
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <utility>
+
+#include "Adafruit_MLX90393.h"
+
+class Adafruit_MLX90393_Executor;
+
+/**
+ * Coroutine return type for acquisition tasks run on an
+ * Adafruit_MLX90393_Executor. Tasks start suspended and only run once
+ * spawned. The task object owns the coroutine frame and must outlive it.
+ */
+class Adafruit_MLX90393_Task {
+ public:
+  struct promise_type {
+    Adafruit_MLX90393_Executor *executor = nullptr;
+
+    Adafruit_MLX90393_Task get_return_object() {
+      return Adafruit_MLX90393_Task(
+          std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+
+  Adafruit_MLX90393_Task(Adafruit_MLX90393_Task &&other)
+      : _handle(std::exchange(other._handle, nullptr)) {}
+  Adafruit_MLX90393_Task &operator=(Adafruit_MLX90393_Task &&other) {
+    if (this != &other) {
+      if (_handle)
+        _handle.destroy();
+      _handle = std::exchange(other._handle, nullptr);
+    }
+    return *this;
+  }
+  ~Adafruit_MLX90393_Task() {
+    if (_handle)
+      _handle.destroy();
+  }
+
+  // True once the coroutine has run to completion.
+  bool done(void) const { return !_handle || _handle.done(); }
+
+ private:
+  friend class Adafruit_MLX90393_Executor;
+
+  explicit Adafruit_MLX90393_Task(
+      std::coroutine_handle<promise_type> handle)
+      : _handle(handle) {}
+
+  std::coroutine_handle<promise_type> _handle;
+};
+
+/**
+ * Minimal cooperative scheduler. Holds up to MaxPending suspended coroutines,
+ * each with the micros() time at which it should resume, and resumes them
+ * from runOnce(). Not thread-safe: call everything from one task/loop.
+ * spawn reports a full executor by returning false; a coroutine awaiting
+ * measure or mlx90393_sleep_us on a full executor calls std::terminate.
+ */
+class Adafruit_MLX90393_Executor {
+ public:
+  static constexpr size_t MaxPending = 16;
+
+  // Schedules a task to start on the next runOnce().
+  bool spawn(Adafruit_MLX90393_Task &task) {
+    if (task.done())
+      return false;
+    task._handle.promise().executor = this;
+    return resumeAt(task._handle, micros());
+  }
+
+  // Parks a coroutine until micros() reaches deadline_us. Returns false if
+  // the executor is full.
+  bool resumeAt(std::coroutine_handle<> handle, uint32_t deadline_us) {
+    if (_count == MaxPending)
+      return false;
+    _pending[_count++] = {handle, deadline_us, nullptr};
+    return true;
+  }
+
+  // Parks a coroutine until sensor's non-blocking measurement has left
+  // MLX90393_MEAS_CONVERTING, polling it whenever its deadline passes.
+  // Returns false if the executor is full.
+  bool resumeWhenDone(std::coroutine_handle<> handle,
+                      Adafruit_MLX90393 *sensor) {
+    if (_count == MaxPending)
+      return false;
+    _pending[_count++] = {handle, sensor->getMeasurementDeadline(), sensor};
+    return true;
+  }
+
+  // Resumes every coroutine whose deadline has passed. Coroutines parked by
+  // those resumptions wait for the next call. Returns how many are still
+  // parked.
+  size_t runOnce(void) {
+    std::coroutine_handle<> due[MaxPending];
+    size_t ndue = 0;
+    const uint32_t now = micros();
+    for (size_t i = 0; i < _count;) {
+      Pending &p = _pending[i];
+      if ((int32_t)(now - p.deadline_us) < 0) {
+        i++;
+      } else if (p.sensor && p.sensor->poll() == MLX90393_MEAS_CONVERTING) {
+        p.deadline_us = p.sensor->getMeasurementDeadline();
+        i++;
+      } else {
+        due[ndue++] = p.handle;
+        p = _pending[--_count];
+      }
+    }
+    for (size_t i = 0; i < ndue; i++)
+      due[i].resume();
+    return _count;
+  }
+
+  // Runs until no coroutine is parked. Busy-waits between deadlines, so this
+  // is mostly useful on the host and in simple sketches.
+  void run(void) {
+    while (runOnce() > 0) {
+    }
+  }
+
+  // Number of parked coroutines.
+  size_t pending(void) const { return _count; }
+
+ private:
+  struct Pending {
+    std::coroutine_handle<> handle;
+    uint32_t deadline_us;
+    Adafruit_MLX90393 *sensor; // Polled before resuming, if set.
+  };
+
+  Pending _pending[MaxPending];
+  size_t _count = 0;
+};
+
+/**
+ * Awaitable returned by Adafruit_MLX90393::measure. Issues SM when awaited,
+ * parks the coroutine until the sensor has read the conversion back (see
+ * poll) and yields the result of tryGetResult. Must be awaited from an
+ * Adafruit_MLX90393_Task.
+ */
+class Adafruit_MLX90393_Measure {
+ public:
+  Adafruit_MLX90393_Measure(Adafruit_MLX90393 *sensor, uint8_t axes,
+                            std::span<float> result)
+      : _sensor(sensor), _axes(axes), _result(result) {}
+
+  bool await_ready(void) const { return false; }
+
+  template <typename Promise>
+  bool await_suspend(std::coroutine_handle<Promise> handle) {
+    // On failure, don't suspend: await_resume then reports false.
+    if (!_sensor->beginMeasurement(_axes))
+      return false;
+    // Resuming at once would look like a failed measurement while the
+    // sensor is still converting. Running out of slots is a sizing error
+    // (see MaxPending), so stop hard instead.
+    if (!handle.promise().executor->resumeWhenDone(handle, _sensor))
+      std::terminate();
+    return true;
+  }
+
+  bool await_resume(void) { return _sensor->tryGetResult(_result); }
+
+ private:
+  Adafruit_MLX90393 *_sensor;
+  uint8_t _axes;
+  std::span<float> _result;
+};
+
+inline Adafruit_MLX90393_Measure
+Adafruit_MLX90393::measure(uint8_t axes, std::span<float> result) {
+  return Adafruit_MLX90393_Measure(this, axes, result);
+}
+
+/**
+ * Awaitable that parks the coroutine for a number of microseconds.
+ */
+class Adafruit_MLX90393_Sleep {
+ public:
+  explicit Adafruit_MLX90393_Sleep(uint32_t us) : _us(us) {}
+
+  bool await_ready(void) const { return _us == 0; }
+
+  template <typename Promise>
+  void await_suspend(std::coroutine_handle<Promise> handle) {
+    // As in Adafruit_MLX90393_Measure, a full executor is a hard error.
+    if (!handle.promise().executor->resumeAt(handle, micros() + _us))
+      std::terminate();
+  }
+
+  void await_resume(void) const {}
+
+ private:
+  uint32_t _us;
+};
+
+inline Adafruit_MLX90393_Sleep mlx90393_sleep_us(uint32_t us) {
+  return Adafruit_MLX90393_Sleep(us);
+}
+
+#endif /* ADAFRUIT_MLX90393_CORO_H */
@@ -0,0 +1,309 @@
+/******************************************************************************
+  FreeRTOS acquisition support for the MLX90393 driver (ESP-IDF only).
+
+  MIT license, all text above must be included in any redistribution
+ *****************************************************************************/
+#include "Adafruit_MLX90393_RTOS.h"
+
+#if defined(ESP_PLATFORM)
+
+#include <algorithm>
+#include <new>
+
+/**
+ * Stops acquisition if it is still running.
+ */
+Adafruit_MLX90393_MultiBus::~Adafruit_MLX90393_MultiBus() { end(); }
+
+/**
+ * Registers the sensor array attached to one I2C controller.
+ *
+ * @param array  The array; must outlive this object.
+ * @param core   CPU to pin the bus task to, or tskNO_AFFINITY.
+ *
+ * @return False if acquisition is running or all bus slots are used.
+ */
+bool Adafruit_MLX90393_MultiBus::addBus(Adafruit_MLX90393_Array *array,
+                                        BaseType_t core) {
+  if (_running || _nbuses == MLX90393_MAX_BUSES) {
+    return false;
+  }
+  _buses[_nbuses] = {this, array, core, (uint8_t)_nbuses};
+  _nbuses++;
+  return true;
+}
+
+/**
+ * Starts one acquisition task per registered bus.
+ *
+ * @param axes         ZYXT bit mask of the axes to convert.
+ * @param queue_depth  Frames the shared queue can hold.
+ * @param priority     FreeRTOS priority of the bus tasks.
+ * @param stack_size   Stack size of each bus task.
+ *
+ * @return True if the queue and every task were created.
+ */
+bool Adafruit_MLX90393_MultiBus::begin(uint8_t axes, UBaseType_t queue_depth,
+                                       UBaseType_t priority,
+                                       uint32_t stack_size) {
+  if (_running || _nbuses == 0) {
+    return false;
+  }
+  _queue = xQueueCreate(queue_depth, sizeof(mlx90393_bus_frame_t));
+  if (!_queue) {
+    return false;
+  }
+  _axes = axes;
+  _dropped = 0;
+  _running = true;
+  for (size_t i = 0; i < _nbuses; i++) {
+    _active++;
+    if (xTaskCreatePinnedToCore(busTask, "mlx90393_bus", stack_size,
+                                &_buses[i], priority, NULL,
+                                _buses[i].core) != pdPASS) {
+      _active--;
+      end();
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Stops the bus tasks once they finish their current frame.
+ */
+void Adafruit_MLX90393_MultiBus::end(void) {
+  _running = false;
+  while (_active > 0) {
+    vTaskDelay(1);
+  }
+  if (_queue) {
+    vQueueDelete(_queue);
+    _queue = nullptr;
+  }
+}
+
+/**
+ * Receives the next frame from any bus.
+ *
+ * @param frame    Where the frame is stored.
+ * @param timeout  How long to wait for one, in ticks.
+ *
+ * @return True if a frame was received.
+ */
+bool Adafruit_MLX90393_MultiBus::receive(mlx90393_bus_frame_t *frame,
+                                         TickType_t timeout) {
+  if (!_queue) {
+    return false;
+  }
+  return xQueueReceive(_queue, frame, timeout) == pdTRUE;
+}
+
+void Adafruit_MLX90393_MultiBus::busTask(void *arg) {
+  Bus *bus = static_cast<Bus *>(arg);
+  Adafruit_MLX90393_MultiBus *owner = bus->owner;
+  mlx90393_bus_frame_t out;
+  out.bus = bus->index;
+  out.seq = 0;
+
+  while (owner->_running) {
+    if (!bus->array->readFrame(owner->_axes, &out.frame) &&
+        out.frame.valid == 0) {
+      /* Nothing on this bus answered; don't spin on the I2C timeout. */
+      vTaskDelay(1);
+      continue;
+    }
+    if (xQueueSend(owner->_queue, &out, 0) != pdTRUE) {
+      owner->_dropped++;
+    }
+    out.seq++;
+  }
+
+  owner->_active--;
+  vTaskDelete(NULL);
+}
+
+/**
+ * Instantiates a service for an initialised sensor.
+ *
+ * @param sensor  The sensor; must outlive the service.
+ */
+Adafruit_MLX90393_Service::Adafruit_MLX90393_Service(
+    Adafruit_MLX90393 *sensor)
+    : _sensor(sensor), _stream(sensor) {}
+
+/**
+ * Stops acquisition if it is still running.
+ */
+Adafruit_MLX90393_Service::~Adafruit_MLX90393_Service() { end(); }
+
+/**
+ * Starts the acquisition task.
+ *
+ * @param mode           Burst or pipelined single-shot acquisition.
+ * @param axes           ZYXT bit mask of the axes to convert.
+ * @param batch_size     Samples per queued batch.
+ * @param queue_depth    Batches the queue can hold.
+ * @param burst_rate_ms  Burst rate, see setBurstRate. Burst mode only.
+ * @param core           CPU to pin the task to, or tskNO_AFFINITY.
+ * @param priority       FreeRTOS priority of the task.
+ * @param stack_size     Stack size of the task.
+ *
+ * @return True if acquisition started.
+ */
+bool Adafruit_MLX90393_Service::begin(mlx90393_service_mode_t mode,
+                                      uint8_t axes, size_t batch_size,
+                                      UBaseType_t queue_depth,
+                                      int burst_rate_ms, BaseType_t core,
+                                      UBaseType_t priority,
+                                      uint32_t stack_size) {
+  if (_running || batch_size == 0) {
+    return false;
+  }
+  _batch = new (std::nothrow) mlx90393_sample_t[batch_size];
+  _queue = xQueueCreate(queue_depth, batch_size * sizeof(mlx90393_sample_t));
+  if (!_batch || !_queue) {
+    end();
+    return false;
+  }
+  _mode = mode;
+  _axes = axes;
+  _batch_size = batch_size;
+  _dropped = 0;
+
+  const bool started = mode == MLX90393_SERVICE_BURST
+                           ? _stream.begin(axes, burst_rate_ms)
+                           : _sensor->startPipelined(axes);
+  if (!started) {
+    end();
+    return false;
+  }
+  _next_burst_us = micros() + _stream.period();
+  _burst_lead_us = MLX90393_RETRY_US;
+
+  _running = true;
+  _active = true;
+  if (xTaskCreatePinnedToCore(serviceTask, "mlx90393_svc", stack_size, this,
+                              priority, NULL, core) != pdPASS) {
+    _active = false;
+    end();
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Stops the acquisition task and releases its resources.
+ */
+void Adafruit_MLX90393_Service::end(void) {
+  if (!_queue && !_batch) {
+    return;
+  }
+  _running = false;
+  while (_active) {
+    vTaskDelay(1);
+  }
+  _sensor->exitMode();
+  if (_queue) {
+    vQueueDelete(_queue);
+    _queue = nullptr;
+  }
+  delete[] _batch;
+  _batch = nullptr;
+}
+
+/**
+ * Receives the next batch of samples.
+ *
+ * @param samples  Room for at least batch_size samples.
+ * @param timeout  How long to wait for a batch, in ticks.
+ *
+ * @return The number of samples received.
+ */
+size_t Adafruit_MLX90393_Service::receive(std::span<mlx90393_sample_t> samples,
+                                          TickType_t timeout) {
+  if (!_queue || samples.size() < _batch_size) {
+    return 0;
+  }
+  if (xQueueReceive(_queue, samples.data(), timeout) != pdTRUE) {
+    return 0;
+  }
+  return _batch_size;
+}
+
+/* Blocks until the next sample is available and returns it. */
+bool Adafruit_MLX90393_Service::acquire(mlx90393_sample_t *sample) {
+  if (_mode == MLX90393_SERVICE_PIPELINED) {
+    if (_sensor->readPipelined(sample)) {
+      return true;
+    }
+    /* A failed read leaves the pipeline idle; restart it. */
+    _sensor->startPipelined(_axes);
+    return false;
+  }
+
+  /* delay() yields to other tasks on this platform. Our timer and the
+   * sensor's drift apart, so a read that lands before the conversion
+   * finishes is retried rather than dropped. */
+  mlx90393_wait_until(_next_burst_us);
+  const uint32_t give_up_us = micros() + MLX90393_TCONV_MARGIN_MS * 1000;
+  bool retried = false;
+  for (;;) {
+    const uint32_t duplicates = _stream.duplicates();
+    const uint32_t read_us = micros();
+    if (_stream.service(read_us)) {
+      /* Aim the next read a little early, so it lands before the edge and
+       * retries onto it. Data on the first try means we were late by an
+       * unknown amount, so double the lead; data after a retry means
+       * read_us is within MLX90393_RETRY_US of the edge, so relax it. */
+      const uint32_t max_lead_us =
+          std::min<uint32_t>(_stream.period() / 2,
+                             MLX90393_TCONV_MARGIN_MS * 1000 -
+                                 MLX90393_RETRY_US);
+      _burst_lead_us =
+          retried ? std::max<uint32_t>(_burst_lead_us / 2, MLX90393_RETRY_US)
+                  : std::min(_burst_lead_us * 2, max_lead_us);
+      _next_burst_us = read_us + _stream.period() - _burst_lead_us;
+      break;
+    }
+    if (_stream.duplicates() == duplicates ||
+        (int32_t)(micros() - give_up_us) >= 0) {
+      _next_burst_us = micros() + _stream.period();
+      return false;
+    }
+    retried = true;
+    mlx90393_wait_until(read_us + MLX90393_RETRY_US);
+  }
+  mlx90393_stream_sample_t entry;
+  if (!_stream.pop(&entry)) {
+    return false;
+  }
+  *sample = entry.sample;
+  return true;
+}
+
+void Adafruit_MLX90393_Service::serviceTask(void *arg) {
+  Adafruit_MLX90393_Service *svc =
+      static_cast<Adafruit_MLX90393_Service *>(arg);
+  size_t filled = 0;
+
+  while (svc->_running) {
+    if (!svc->acquire(&svc->_batch[filled])) {
+      /* Don't spin on a sensor that has stopped answering. */
+      vTaskDelay(1);
+      continue;
+    }
+    if (++filled < svc->_batch_size) {
+      continue;
+    }
+    filled = 0;
+    if (xQueueSend(svc->_queue, svc->_batch, 0) != pdTRUE) {
+      svc->_dropped++;
+    }
+  }
+
+  svc->_active = false;
+  vTaskDelete(NULL);
+}
+
+#endif /* ESP_PLATFORM */
@@ -0,0 +1,168 @@
+/******************************************************************************
+  FreeRTOS acquisition support for the MLX90393 driver (ESP-IDF only).
+
+  Adafruit_MLX90393_MultiBus runs one task per I2C controller, each driving
+  its own Adafruit_MLX90393_Array, and publishes their frames into a single
+  FreeRTOS queue. Parts with two controllers (ESP32) can thereby acquire
+  two arrays in parallel instead of hanging every sensor off &Wire. Frame
+  timestamps come from micros(), which is shared by both cores.
+
+  Adafruit_MLX90393_Service owns a single sensor and runs burst or
+  pipelined single-shot acquisition in its own task, handing samples to the
+  application through a FreeRTOS queue in batches, so the application
+  neither polls from loop() nor wakes up once per sample.
+
+  Adafruit_MLX90393_MutexLock is a bus lock backed by a FreeRTOS mutex, for
+  sensors on one bus that are driven from several tasks.
+
+  MIT license, all text above must be included in any redistribution
+ *****************************************************************************/
+#ifndef ADAFRUIT_MLX90393_RTOS_H
+#define ADAFRUIT_MLX90393_RTOS_H
+
+#if defined(ESP_PLATFORM)
+
+#include <atomic>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include "Adafruit_MLX90393_Array.h"
+#include "Adafruit_MLX90393_Stream.h"
+
+#define MLX90393_MAX_BUSES (2) /**< I2C controllers on an ESP32. */
+
+/**
+ * Bus lock backed by a statically allocated FreeRTOS mutex. Give every
+ * instance on the bus the same lock with setBusLock.
+ */
+class Adafruit_MLX90393_MutexLock : public Adafruit_MLX90393_BusLock {
+ public:
+  Adafruit_MLX90393_MutexLock()
+      : _mutex(xSemaphoreCreateMutexStatic(&_storage)) {}
+  ~Adafruit_MLX90393_MutexLock() { vSemaphoreDelete(_mutex); }
+
+  // The mutex lives inside the object, so a copy would delete it twice.
+  Adafruit_MLX90393_MutexLock(const Adafruit_MLX90393_MutexLock &) = delete;
+  Adafruit_MLX90393_MutexLock &
+  operator=(const Adafruit_MLX90393_MutexLock &) = delete;
+
+  void lock(void) override { xSemaphoreTake(_mutex, portMAX_DELAY); }
+  void unlock(void) override { xSemaphoreGive(_mutex); }
+
+ private:
+  StaticSemaphore_t _storage;
+  SemaphoreHandle_t _mutex;
+};
+
+/** A frame tagged with the bus it was acquired on. */
+typedef struct mlx90393_bus_frame {
+  uint8_t bus;            /**< Index of the bus, in addBus order. */
+  uint32_t seq;           /**< Per-bus frame counter. */
+  mlx90393_frame_t frame; /**< Samples carry mid-conversion timestamps. */
+} mlx90393_bus_frame_t;
+
+/**
+ * Parallel acquisition across several I2C controllers, one task per bus.
+ */
+class Adafruit_MLX90393_MultiBus {
+ public:
+  ~Adafruit_MLX90393_MultiBus();
+
+  // Registers the array of sensors on one controller. core selects the CPU
+  // the bus task is pinned to, or tskNO_AFFINITY to let the scheduler pick.
+  bool addBus(Adafruit_MLX90393_Array *array, BaseType_t core = tskNO_AFFINITY);
+
+  // Creates the shared queue and starts one task per bus, each reading
+  // frames of axes back to back.
+  bool begin(uint8_t axes = MLX90393_AXIS_ALL, UBaseType_t queue_depth = 8,
+             UBaseType_t priority = 5, uint32_t stack_size = 4096);
+
+  // Stops the bus tasks and frees the queue.
+  void end(void);
+
+  // Waits up to timeout for the next frame from any bus.
+  bool receive(mlx90393_bus_frame_t *frame,
+               TickType_t timeout = portMAX_DELAY);
+
+  // Frames discarded because the consumer fell behind.
+  uint32_t dropped(void) const { return _dropped; }
+
+ private:
+  struct Bus {
+    Adafruit_MLX90393_MultiBus *owner;
+    Adafruit_MLX90393_Array *array;
+    BaseType_t core;
+    uint8_t index;
+  };
+
+  static void busTask(void *arg);
+
+  Bus _buses[MLX90393_MAX_BUSES];
+  size_t _nbuses = 0;
+  uint8_t _axes = MLX90393_AXIS_ALL;
+  QueueHandle_t _queue = nullptr;
+  std::atomic<bool> _running{false};
+  std::atomic<int> _active{0};
+  std::atomic<uint32_t> _dropped{0};
+};
+
+/** How Adafruit_MLX90393_Service acquires samples. */
+typedef enum mlx90393_service_mode {
+  MLX90393_SERVICE_PIPELINED, /**< Back-to-back pipelined single shots. */
+  MLX90393_SERVICE_BURST,     /**< Burst mode, read once per burst period. */
+} mlx90393_service_mode_t;
+
+/**
+ * Dedicated acquisition task for one sensor with batched sample delivery.
+ * While it runs, the task owns the sensor: don't call it from elsewhere.
+ */
+class Adafruit_MLX90393_Service {
+ public:
+  explicit Adafruit_MLX90393_Service(Adafruit_MLX90393 *sensor);
+  ~Adafruit_MLX90393_Service();
+
+  // Starts acquiring axes in the given mode and queuing batches of
+  // batch_size samples. burst_rate_ms only applies to burst mode.
+  bool begin(mlx90393_service_mode_t mode, uint8_t axes = MLX90393_AXIS_ALL,
+             size_t batch_size = 8, UBaseType_t queue_depth = 4,
+             int burst_rate_ms = 0, BaseType_t core = tskNO_AFFINITY,
+             UBaseType_t priority = 5, uint32_t stack_size = 4096);
+
+  // Stops the task, takes the sensor out of burst/single mode and frees the
+  // queue.
+  void end(void);
+
+  // Waits up to timeout for the next batch. samples must hold at least
+  // batch_size entries; returns the number of samples written (batch_size
+  // or 0).
+  size_t receive(std::span<mlx90393_sample_t> samples,
+                 TickType_t timeout = portMAX_DELAY);
+
+  // Batches discarded because the consumer fell behind.
+  uint32_t dropped(void) const { return _dropped; }
+
+ private:
+  static void serviceTask(void *arg);
+  bool acquire(mlx90393_sample_t *sample);
+
+  Adafruit_MLX90393 *_sensor;
+  Adafruit_MLX90393_BurstStream<4> _stream;
+  mlx90393_service_mode_t _mode = MLX90393_SERVICE_PIPELINED;
+  uint8_t _axes = MLX90393_AXIS_ALL;
+  size_t _batch_size = 0;
+  mlx90393_sample_t *_batch = nullptr;
+  uint32_t _next_burst_us = 0;
+  uint32_t _burst_lead_us = MLX90393_RETRY_US;
+
+  QueueHandle_t _queue = nullptr;
+  std::atomic<bool> _running{false};
+  std::atomic<bool> _active{false};
+  std::atomic<uint32_t> _dropped{0};
+};
+
+#endif /* ESP_PLATFORM */
+
+#endif /* ADAFRUIT_MLX90393_RTOS_H */
@@ -0,0 +1,200 @@
+/******************************************************************************
+  Burst-mode streaming for the MLX90393 driver.
+
+  Adafruit_MLX90393_BurstStream puts the sensor in burst mode and collects
+  samples into a fixed-capacity ring buffer. Call service() whenever a new
+  sample should be available: when the INT/DRDY pin rises (set a flag in the
+  ISR and service it from loop or a task, since service() talks I2C) or from
+  a timer running at the burst rate. Each sample is tagged with a sequence
+  number and a mid-conversion timestamp, and the stream counts samples that
+  were missed or dropped because the consumer fell behind, and calls that
+  found no new data.
+
+  Adafruit_MLX90393_SpscQueue is a wait-free single-producer/single-consumer
+  queue for handing samples from an ISR or acquisition task to the
+  application without locks.
+
+  MIT license, all text above must be included in any redistribution
+ *****************************************************************************/
+#ifndef ADAFRUIT_MLX90393_STREAM_H
+#define ADAFRUIT_MLX90393_STREAM_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+
+#include "Adafruit_MLX90393.h"
+
+/** One entry of a burst stream. */
+typedef struct mlx90393_stream_sample {
+  uint32_t seq;             /**< Sequence number; gaps mean missed samples. */
+  mlx90393_sample_t sample; /**< The measurement, timestamped. */
+} mlx90393_stream_sample_t;
+
+/**
+ * Burst-mode reader with a ring buffer of Capacity samples. When the buffer
+ * is full the oldest sample is overwritten and counted as an overrun.
+ */
+template <size_t Capacity> class Adafruit_MLX90393_BurstStream {
+  static_assert(Capacity > 0, "Capacity must be non-zero");
+
+ public:
+  explicit Adafruit_MLX90393_BurstStream(Adafruit_MLX90393 *sensor)
+      : _sensor(sensor) {}
+
+  // Sets the burst rate (see setBurstRate) and starts burst mode on axes.
+  bool begin(uint8_t axes = MLX90393_AXIS_ALL, int burst_rate_ms = 0) {
+    if (!_sensor->setBurstRate(burst_rate_ms)) {
+      return false;
+    }
+    _axes = axes;
+    // Same clamping as setBurstRate; a rate of 0 means back-to-back
+    // conversions, so the period can never be shorter than one conversion.
+    const uint32_t rate_us =
+        std::clamp(burst_rate_ms / 20, 0, 0b111111) * 20000;
+    _tconv_us = _sensor->getConversionTimeUs(axes);
+    _period_us = std::max(rate_us, _tconv_us);
+    _have_last = false;
+    _next_seq = 0;
+    return _sensor->startBurstMode(axes);
+  }
+
+  // Leaves burst mode. Buffered samples remain available.
+  bool end(void) { return _sensor->exitMode(); }
+
+  // Reads the sample the sensor signalled at timestamp_us (the DRDY edge,
+  // i.e. the end of the conversion) and buffers it. The sample is stamped
+  // with the middle of its conversion window rather than the time of the
+  // read, so bus latency doesn't leak into it. Returns false if nothing new
+  // was buffered; if that's because the sensor had no new data (see
+  // mlx90393_status_not_ready) it counts as a duplicate, not an error.
+  bool service(uint32_t timestamp_us) {
+    mlx90393_stream_sample_t entry;
+    if (!_sensor->readMeasurement(_axes, &entry.sample)) {
+      if (mlx90393_status_not_ready(entry.sample.status)) {
+        _duplicates++;
+      } else {
+        _errors++;
+      }
+      return false;
+    }
+    // Burst mode was left behind our back, e.g. by a reset or brown-out.
+    if ((entry.sample.status & MLX90393_STATUS_BURSTMODE) == 0 ||
+        (entry.sample.status & MLX90393_STATUS_RESET) != 0) {
+      _errors++;
+      return false;
+    }
+    if (_have_last) {
+      // Conversions the sensor finished that we never read.
+      const uint32_t elapsed = timestamp_us - _last_timestamp_us;
+      if (elapsed > _period_us + _period_us / 2) {
+        const uint32_t skipped = (elapsed + _period_us / 2) / _period_us - 1;
+        _missed += skipped;
+        _next_seq += skipped;
+      }
+    }
+    _last_timestamp_us = timestamp_us;
+    _have_last = true;
+
+    entry.seq = _next_seq++;
+    entry.sample.timestamp_us = timestamp_us - _tconv_us / 2;
+    if (_count == Capacity) {
+      _tail = (_tail + 1) % Capacity;
+      _count--;
+      _overruns++;
+    }
+    _buffer[_head] = entry;
+    _head = (_head + 1) % Capacity;
+    _count++;
+    return true;
+  }
+  bool service(void) { return service(micros()); }
+
+  // Removes the oldest buffered sample. Returns false if the buffer is empty.
+  bool pop(mlx90393_stream_sample_t *out) {
+    if (_count == 0) {
+      return false;
+    }
+    *out = _buffer[_tail];
+    _tail = (_tail + 1) % Capacity;
+    _count--;
+    return true;
+  }
+
+  size_t available(void) const { return _count; }
+
+  // Expected time between samples, in microseconds.
+  uint32_t period(void) const { return _period_us; }
+
+  uint32_t overruns(void) const { return _overruns; }
+  uint32_t missed(void) const { return _missed; }
+  uint32_t duplicates(void) const { return _duplicates; }
+  uint32_t errors(void) const { return _errors; }
+
+ private:
+  Adafruit_MLX90393 *_sensor;
+  uint8_t _axes = MLX90393_AXIS_ALL;
+  uint32_t _period_us = 0;
+  uint32_t _tconv_us = 0;
+
+  mlx90393_stream_sample_t _buffer[Capacity];
+  size_t _head = 0, _tail = 0, _count = 0;
+
+  uint32_t _last_timestamp_us = 0;
+  bool _have_last = false;
+  uint32_t _next_seq = 0;
+
+  uint32_t _overruns = 0, _missed = 0, _duplicates = 0, _errors = 0;
+};
+
+/**
+ * Wait-free single-producer/single-consumer queue of up to Capacity items,
+ * with no allocation and no locks. Exactly one context (e.g. an ISR or the
+ * acquisition task calling readMeasurement) may call push, and exactly one
+ * other context may call pop. Capacity must be a power of two so indices
+ * wrap with a mask.
+ */
+template <typename T, size_t Capacity> class Adafruit_MLX90393_SpscQueue {
+  static_assert(std::has_single_bit(Capacity),
+                "Capacity must be a power of two");
+
+ public:
+  // Producer side. Returns false, leaving the queue untouched, if full.
+  bool push(const T &item) {
+    const size_t head = _head.load(std::memory_order_relaxed);
+    if (head - _tail.load(std::memory_order_acquire) == Capacity) {
+      return false;
+    }
+    _items[head & (Capacity - 1)] = item;
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Returns false if empty.
+  bool pop(T *item) {
+    const size_t tail = _tail.load(std::memory_order_relaxed);
+    if (_head.load(std::memory_order_acquire) == tail) {
+      return false;
+    }
+    *item = _items[tail & (Capacity - 1)];
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Either side; only a snapshot while the other side is running.
+  size_t size(void) const {
+    return _head.load(std::memory_order_acquire) -
+           _tail.load(std::memory_order_acquire);
+  }
+  bool empty(void) const { return size() == 0; }
+
+ private:
+  // The counters run freely and wrap; only their difference and the low
+  // bits matter. Keep them apart so the two sides don't share a line.
+  alignas(32) std::atomic<size_t> _head{0};
+  alignas(32) std::atomic<size_t> _tail{0};
+  T _items[Capacity];
+};
+
+#endif /* ADAFRUIT_MLX90393_STREAM_H */
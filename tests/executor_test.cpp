@@ -0,0 +1,148 @@
+/******************************************************************************
+  Host test for Adafruit_MLX90393_Executor and the measure() awaitable,
+  against a simulated MLX90393 that rejects the first few RM commands of
+  each conversion as not ready.
+ *****************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "Adafruit_MLX90393_Coro.h"
+
+#define CHECK(cond)                                                           \
+  do {                                                                        \
+    if (!(cond)) {                                                            \
+      std::fprintf(stderr, "FAIL: %s:%d: %s\n", __FILE__, __LINE__, #cond);   \
+      std::exit(1);                                                           \
+    }                                                                         \
+  } while (0)
+
+namespace {
+
+/* Just enough of the command set for begin_I2C, SM and RM. */
+struct FakeSensor {
+  uint16_t regs[64] = {};
+  uint8_t mode = 0;
+  int not_ready_rms = 0; // RM rejections left for the current conversion
+  int rejected = 0;
+
+  std::vector<uint8_t> command(const std::vector<uint8_t> &tx) {
+    const uint8_t cmd = tx[0] & 0xF0, zyxt = tx[0] & 0x0F;
+    switch (cmd) {
+    case MLX90393_REG_EX:
+    case MLX90393_REG_RT:
+      mode = 0;
+      return {uint8_t(cmd == MLX90393_REG_RT ? MLX90393_STATUS_RESET : 0)};
+    case MLX90393_REG_RR: {
+      const uint16_t v = regs[tx[1] >> 2];
+      return {0, uint8_t(v >> 8), uint8_t(v)};
+    }
+    case MLX90393_REG_WR:
+      regs[tx[3] >> 2] = (tx[1] << 8) | tx[2];
+      return {0};
+    case MLX90393_REG_SM:
+      mode = MLX90393_STATUS_SMMODE;
+      not_ready_rms = 2;
+      return {mode};
+    case MLX90393_REG_RM: {
+      std::vector<uint8_t> rx(1 + 2 * std::popcount(zyxt), 0);
+      if (mode == MLX90393_STATUS_SMMODE && not_ready_rms > 0) {
+        not_ready_rms--;
+        rejected++;
+        rx[0] = mode | MLX90393_STATUS_ERROR;
+        return rx;
+      }
+      rx[0] = mode;
+      mode = 0;
+      for (size_t i = 1; i < rx.size(); i += 2) {
+        rx[i + 1] = 100; // 100 counts on every axis
+      }
+      return rx;
+    }
+    default:
+      return {0};
+    }
+  }
+};
+
+FakeSensor fake;
+std::vector<int> events;
+
+Adafruit_MLX90393_Task sleeper(int id, uint32_t us) {
+  co_await mlx90393_sleep_us(us);
+  events.push_back(id);
+  co_await mlx90393_sleep_us(us);
+  events.push_back(id);
+}
+
+Adafruit_MLX90393_Task measurer(Adafruit_MLX90393 &sensor, bool *ok,
+                                float *xyz) {
+  *ok = co_await sensor.measure(MLX90393_AXIS_ALL, std::span<float>(xyz, 3));
+}
+
+void testSleepOrdering() {
+  Adafruit_MLX90393_Executor executor;
+  Adafruit_MLX90393_Task slow = sleeper(2, 3000);
+  Adafruit_MLX90393_Task fast = sleeper(1, 1000);
+  CHECK(executor.spawn(slow));
+  CHECK(executor.spawn(fast));
+  executor.run();
+  CHECK(slow.done() && fast.done());
+  CHECK((events == std::vector<int>{1, 1, 2, 2}));
+}
+
+void testCapacity() {
+  Adafruit_MLX90393_Executor executor;
+  std::vector<Adafruit_MLX90393_Task> tasks;
+  for (size_t i = 0; i <= Adafruit_MLX90393_Executor::MaxPending; i++) {
+    tasks.push_back(sleeper(0, 0));
+  }
+  for (size_t i = 0; i < Adafruit_MLX90393_Executor::MaxPending; i++) {
+    CHECK(executor.spawn(tasks[i]));
+  }
+  CHECK(!executor.spawn(tasks.back()));
+  executor.run();
+}
+
+void testMeasure() {
+  Wire.setDevice([](uint8_t addr, const std::vector<uint8_t> &tx) {
+    return addr == MLX90393_DEFAULT_ADDR ? fake.command(tx)
+                                         : std::vector<uint8_t>();
+  });
+  Adafruit_MLX90393 sensor;
+  CHECK(sensor.begin_I2C());
+  CHECK(sensor.setFilter(MLX90393_FILTER_0));
+  CHECK(sensor.setOversampling(MLX90393_OSR_0));
+
+  /* Not-ready RMs are retried, not reported as a failed measurement. */
+  Adafruit_MLX90393_Executor executor;
+  bool ok = false;
+  float xyz[3] = {};
+  Adafruit_MLX90393_Task task = measurer(sensor, &ok, xyz);
+  CHECK(executor.spawn(task));
+  executor.run();
+  CHECK(task.done());
+  CHECK(ok);
+  CHECK(fake.rejected == 2);
+  CHECK(xyz[0] > 0 && xyz[1] > 0 && xyz[2] > 0);
+
+  /* A sensor that isn't there fails the measurement. */
+  Adafruit_MLX90393 absent;
+  absent.attach(MLX90393_DEFAULT_ADDR + 1);
+  ok = true;
+  Adafruit_MLX90393_Task missing = measurer(absent, &ok, xyz);
+  CHECK(executor.spawn(missing));
+  executor.run();
+  CHECK(missing.done());
+  CHECK(!ok);
+}
+
+} // namespace
+
+int main() {
+  testSleepOrdering();
+  testCapacity();
+  testMeasure();
+  std::printf("executor_test: passed\n");
+  return 0;
+}
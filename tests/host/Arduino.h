@@ -0,0 +1,29 @@
+/******************************************************************************
+  Minimal stand-in for the Arduino core, for building the driver on a host.
+  Time comes from the host's steady clock.
+ *****************************************************************************/
+#ifndef MLX90393_HOST_ARDUINO_H
+#define MLX90393_HOST_ARDUINO_H
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+inline uint32_t micros(void) {
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<microseconds>(
+             steady_clock::now().time_since_epoch())
+      .count();
+}
+inline uint32_t millis(void) { return micros() / 1000; }
+inline void delay(uint32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+inline void delayMicroseconds(uint32_t us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+#endif /* MLX90393_HOST_ARDUINO_H */
@@ -0,0 +1,56 @@
+/******************************************************************************
+  Minimal stand-in for the Arduino Wire library, for building the driver on
+  a host. A test installs a device callback that receives each write and
+  returns the bytes the following read should see; with no callback every
+  transaction is NACKed.
+ *****************************************************************************/
+#ifndef MLX90393_HOST_WIRE_H
+#define MLX90393_HOST_WIRE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+class TwoWire {
+ public:
+  using Device = std::function<std::vector<uint8_t>(
+      uint8_t, const std::vector<uint8_t> &)>;
+
+  void begin(void) {}
+  void setDevice(Device device) { _device = device; }
+
+  void beginTransmission(uint8_t addr) {
+    _addr = addr;
+    _tx.clear();
+  }
+  size_t write(const uint8_t *data, size_t len) {
+    _tx.insert(_tx.end(), data, data + len);
+    return len;
+  }
+  uint8_t endTransmission(bool stop = true) {
+    (void)stop;
+    _rx[_addr] = _device ? _device(_addr, _tx) : std::vector<uint8_t>();
+    return _rx[_addr].empty() ? 2 : 0;
+  }
+  uint8_t requestFrom(uint8_t addr, uint8_t len) {
+    _read = _rx[addr];
+    return _read.size() >= len ? len : 0;
+  }
+  size_t readBytes(uint8_t *data, size_t len) {
+    len = std::min(len, _read.size());
+    std::copy(_read.begin(), _read.begin() + len, data);
+    return len;
+  }
+
+ private:
+  Device _device;
+  uint8_t _addr = 0;
+  std::vector<uint8_t> _tx, _read;
+  std::map<uint8_t, std::vector<uint8_t>> _rx;
+};
+
+inline TwoWire Wire;
+
+#endif /* MLX90393_HOST_WIRE_H */
@@ -0,0 +1,72 @@
+/******************************************************************************
+  Stress test for Adafruit_MLX90393_SpscQueue: one thread pushes a running
+  sequence, another pops it, and every item must arrive exactly once and in
+  order. Build with -fsanitize=thread (MLX90393_TSAN) to also check the
+  memory ordering.
+ *****************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "Adafruit_MLX90393_Stream.h"
+
+namespace {
+
+constexpr uint32_t kItems = 200000;
+
+/* Two words, so a torn copy shows up as a mismatch. */
+struct Item {
+  uint32_t seq;
+  uint32_t check;
+};
+
+Adafruit_MLX90393_SpscQueue<Item, 64> queue;
+
+void fail(const char *what, uint32_t expected, uint32_t got) {
+  std::fprintf(stderr, "FAIL: %s (expected %u, got %u)\n", what,
+               (unsigned)expected, (unsigned)got);
+  std::exit(1);
+}
+
+} // namespace
+
+int main() {
+  std::thread producer([] {
+    for (uint32_t seq = 0; seq < kItems;) {
+      if (queue.push({seq, ~seq})) {
+        seq++;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  uint32_t expected = 0;
+  std::thread consumer([&expected] {
+    Item item;
+    while (expected < kItems) {
+      if (!queue.pop(&item)) {
+        std::this_thread::yield();
+        continue;
+      }
+      if (item.check != ~item.seq) {
+        fail("torn item", ~item.seq, item.check);
+      }
+      if (item.seq != expected) {
+        fail(item.seq < expected ? "duplicated item" : "lost or reordered item",
+             expected, item.seq);
+      }
+      expected++;
+    }
+  });
+
+  producer.join();
+  consumer.join();
+
+  Item item;
+  if (!queue.empty() || queue.pop(&item)) {
+    fail("items left over", 0, (uint32_t)queue.size());
+  }
+  std::printf("spsc_stress: %u items in order\n", (unsigned)expected);
+  return 0;
+}